@@ -0,0 +1,69 @@
+#include <benchmark/benchmark.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "benchmarks/alloc_counter.h"
+#include "model/parser.h"
+
+namespace {
+
+const int kGridSide = 700;
+
+const s21::WireframeObject &SampleModel() {
+  static const s21::WireframeObject model = [] {
+    std::string file_path =
+        (std::filesystem::temp_directory_path() / "3dviewer_bench_repaint.obj")
+            .string();
+    std::ofstream file(file_path, std::ios::trunc);
+    for (int y = 0; y < kGridSide; ++y) {
+      for (int x = 0; x < kGridSide; ++x) {
+        file << "v " << x * 0.001f << ' ' << y * 0.001f << " 0\n";
+      }
+    }
+    for (int y = 0; y + 1 < kGridSide; ++y) {
+      for (int x = 0; x + 1 < kGridSide; ++x) {
+        int a = y * kGridSide + x + 1;
+        file << "f " << a << ' ' << a + 1 << ' ' << a + kGridSide + 1 << '\n';
+        file << "f " << a << ' ' << a + kGridSide + 1 << ' ' << a + kGridSide
+             << '\n';
+      }
+    }
+    file.close();
+    return s21::WireframeObject(file_path);
+  }();
+  return model;
+}
+
+// Walks the model the way Scene::paintGL and DrawAllVertices do, with the
+// glVertex3f calls replaced by a running sum
+float TraverseLikeRepaint(const s21::WireframeObject &model) {
+  float sum = 0.0f;
+  const auto vertices = model.GetVertices();
+  for (const s21::Face &face : model.GetFaces()) {
+    for (int i = 0; i < 3; ++i) {
+      const s21::Coordinate &from = vertices[face.index[i]];
+      const s21::Coordinate &to = vertices[face.index[(i + 1) % 3]];
+      sum += from.x + to.y;
+    }
+  }
+  benchmark::DoNotOptimize(model.GetVertices().data());
+  benchmark::DoNotOptimize(model.GetVertexCount());
+  return sum;
+}
+
+}  // namespace
+
+static void BM_RepaintTraversal(benchmark::State &state) {
+  const s21::WireframeObject &model = SampleModel();
+  std::size_t allocations = s21::AllocationCount();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(TraverseLikeRepaint(model));
+  }
+  allocations = s21::AllocationCount() - allocations;
+  state.counters["allocs_per_frame"] = benchmark::Counter(
+      static_cast<double>(allocations), benchmark::Counter::kAvgIterations);
+  state.counters["faces"] = static_cast<double>(model.GetFaceCount());
+}
+BENCHMARK(BM_RepaintTraversal)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,29 @@
+#include "benchmarks/alloc_counter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+std::atomic<std::size_t> allocation_count{0};
+}  // namespace
+
+namespace s21 {
+std::size_t AllocationCount() {
+  return allocation_count.load(std::memory_order_relaxed);
+}
+}  // namespace s21
+
+// Counting replacements for the global allocation functions; every other
+// operator new/delete overload forwards to these two
+void *operator new(std::size_t size) {
+  allocation_count.fetch_add(1, std::memory_order_relaxed);
+  if (void *pointer = std::malloc(size == 0 ? 1 : size)) return pointer;
+  throw std::bad_alloc();
+}
+
+void operator delete(void *pointer) noexcept { std::free(pointer); }
+
+void operator delete(void *pointer, std::size_t) noexcept {
+  std::free(pointer);
+}
@@ -0,0 +1,11 @@
+#ifndef BENCHMARKS_ALLOC_COUNTER_H
+#define BENCHMARKS_ALLOC_COUNTER_H
+
+#include <cstddef>
+
+namespace s21 {
+// Number of global operator new calls since the benchmark binary started
+std::size_t AllocationCount();
+}  // namespace s21
+
+#endif  // BENCHMARKS_ALLOC_COUNTER_H
@@ -0,0 +1,330 @@
+#include <benchmark/benchmark.h>
+#include <zlib.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "benchmarks/alloc_counter.h"
+#include "model/edge_list.h"
+#include "model/gltf_loader.h"
+#include "model/mesh_lod.h"
+#include "model/parser.h"
+#include "model/vertex_weld.h"
+
+namespace {
+
+// Grid of kGridSide x kGridSide vertices split into two triangles per cell:
+// 1M vertices and ~2M faces, roughly the size of our scanned meshes.
+const int kGridSide = 1000;
+
+std::string WriteGridSample(int side) {
+  std::string file_path =
+      (std::filesystem::temp_directory_path() /
+       ("3dviewer_bench_grid_" + std::to_string(side) + ".obj"))
+          .string();
+  std::ofstream file(file_path, std::ios::trunc);
+  for (int y = 0; y < side; ++y) {
+    for (int x = 0; x < side; ++x) {
+      file << "v " << x * 0.001f << ' ' << y * 0.001f << ' '
+           << (x * y % 7) * 0.01f << '\n';
+    }
+  }
+  for (int y = 0; y + 1 < side; ++y) {
+    for (int x = 0; x + 1 < side; ++x) {
+      int a = y * side + x + 1;
+      int b = a + 1;
+      int c = a + side;
+      int d = c + 1;
+      file << "f " << a << ' ' << b << ' ' << d << '\n';
+      file << "f " << a << ' ' << d << ' ' << c << '\n';
+    }
+  }
+  return file_path;
+}
+
+const std::string &LargeSamplePath() {
+  static const std::string path = WriteGridSample(kGridSide);
+  return path;
+}
+
+template <typename T>
+void AppendBinary(std::ofstream &file, T value) {
+  file.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+// The large sample converted to format, for comparing the loaders
+std::string WriteGridAs(s21::MeshFormatT format) {
+  if (format == s21::kFormatObj) return LargeSamplePath();
+  s21::WireframeObject grid(LargeSamplePath());
+  auto vertices = grid.GetVertices();
+  auto faces = grid.GetFaces();
+  const char *extension = format == s21::kFormatStl   ? ".stl"
+                          : format == s21::kFormatPly ? ".ply"
+                                                      : ".glb";
+  std::string file_path = LargeSamplePath() + extension;
+  std::ofstream file(file_path, std::ios::binary | std::ios::trunc);
+  if (format == s21::kFormatGltf) {
+    // Packed positions and 32-bit indices in the BIN chunk: the mapped case
+    std::uint64_t positions = vertices.size_bytes();
+    std::uint64_t indices = faces.size_bytes();
+    std::string json =
+        R"({"asset":{"version":"2.0"},"meshes":[{"primitives":[{)"
+        R"("attributes":{"POSITION":0},"indices":1}]}],"accessors":[)"
+        R"({"bufferView":0,"componentType":5126,"type":"VEC3","count":)" +
+        std::to_string(vertices.size()) +
+        R"(},{"bufferView":1,"componentType":5125,"type":"SCALAR","count":)" +
+        std::to_string(faces.size() * 3) +
+        R"(}],"bufferViews":[{"buffer":0,"byteLength":)" +
+        std::to_string(positions) +
+        R"(},{"buffer":0,"byteOffset":)" + std::to_string(positions) +
+        R"(,"byteLength":)" + std::to_string(indices) +
+        R"(}],"buffers":[{"byteLength":)" +
+        std::to_string(positions + indices) + "}]}";
+    json.resize((json.size() + 3) / 4 * 4, ' ');
+    file << "glTF";
+    AppendBinary<std::uint32_t>(file, 2);
+    AppendBinary<std::uint32_t>(
+        file, s21::kGlbHeaderBytes + 2 * s21::kGlbChunkHeaderBytes +
+                  json.size() + positions + indices);
+    AppendBinary<std::uint32_t>(file, json.size());
+    AppendBinary(file, s21::kGlbChunkJson);
+    file << json;
+    AppendBinary<std::uint32_t>(file, positions + indices);
+    AppendBinary(file, s21::kGlbChunkBin);
+    file.write(reinterpret_cast<const char *>(vertices.data()), positions);
+    file.write(reinterpret_cast<const char *>(faces.data()), indices);
+  } else if (format == s21::kFormatStl) {
+    file << std::string(80, ' ');
+    AppendBinary<std::uint32_t>(file, faces.size());
+    for (const s21::Face &face : faces) {
+      for (int i = 0; i < 3; ++i) AppendBinary(file, 0.0f);
+      for (std::uint32_t index : face.index) AppendBinary(file, vertices[index]);
+      AppendBinary<std::uint16_t>(file, 0);
+    }
+  } else {
+    file << "ply\nformat binary_little_endian 1.0\nelement vertex "
+         << vertices.size()
+         << "\nproperty float x\nproperty float y\nproperty float z\n"
+            "element face "
+         << faces.size()
+         << "\nproperty list uchar int vertex_indices\nend_header\n";
+    for (const s21::Coordinate &vertex : vertices) AppendBinary(file, vertex);
+    for (const s21::Face &face : faces) {
+      AppendBinary<std::uint8_t>(file, 3);
+      for (std::uint32_t index : face.index) AppendBinary(file, index);
+    }
+  }
+  return file_path;
+}
+
+}  // namespace
+
+static void BM_LoadLargeObj(benchmark::State &state) {
+  const std::string &path = LargeSamplePath();
+  s21::LoadOptions options;
+  options.mode = static_cast<s21::LoadModeT>(state.range(0));
+  for (auto _ : state) {
+    s21::WireframeObject obj(path, options);
+    benchmark::DoNotOptimize(obj.GetId());
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          std::filesystem::file_size(path));
+}
+BENCHMARK(BM_LoadLargeObj)
+    ->ArgName("mode")
+    ->Arg(s21::kLoadMapped)
+    ->Arg(s21::kLoadStream)
+    ->Unit(benchmark::kMillisecond)
+    ->Iterations(3);
+
+static void BM_LoadLargeObjThreads(benchmark::State &state) {
+  const std::string &path = LargeSamplePath();
+  s21::LoadOptions options;
+  options.thread_count = static_cast<unsigned>(state.range(0));
+  for (auto _ : state) {
+    s21::WireframeObject obj(path, options);
+    benchmark::DoNotOptimize(obj.GetId());
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          std::filesystem::file_size(path));
+}
+BENCHMARK(BM_LoadLargeObjThreads)
+    ->ArgName("threads")
+    ->RangeMultiplier(2)
+    ->Range(1, 16)
+    ->Unit(benchmark::kMillisecond)
+    ->Iterations(3)
+    ->UseRealTime();
+
+// Warm open through the binary mesh cache: hash the source, map the entry
+static void BM_LoadLargeObjCached(benchmark::State &state) {
+  const std::string &path = LargeSamplePath();
+  s21::LoadOptions options;
+  options.use_cache = true;
+  options.cache_dir =
+      (std::filesystem::temp_directory_path() / "3dviewer_bench_cache")
+          .string();
+  // The first load parses and writes the entry
+  benchmark::DoNotOptimize(s21::WireframeObject::Load(path, options));
+  for (auto _ : state) {
+    auto obj = s21::WireframeObject::Load(path, options);
+    benchmark::DoNotOptimize(obj->GetFaceCount());
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          std::filesystem::file_size(path));
+  std::filesystem::remove_all(options.cache_dir);
+}
+BENCHMARK(BM_LoadLargeObjCached)->Unit(benchmark::kMillisecond);
+
+// Inflating on its own thread overlaps with parsing: compare with the
+// serial stream mode over the same text in BM_LoadLargeObj
+static void BM_LoadLargeObjGzip(benchmark::State &state) {
+  const std::string &path = LargeSamplePath();
+  std::string gzip_path = path + ".gz";
+  {
+    std::ifstream file(path, std::ios::binary);
+    std::string text((std::istreambuf_iterator<char>(file)),
+                     std::istreambuf_iterator<char>());
+    gzFile gzip = gzopen(gzip_path.c_str(), "wb");
+    gzwrite(gzip, text.data(), static_cast<unsigned>(text.size()));
+    gzclose(gzip);
+  }
+  for (auto _ : state) {
+    s21::WireframeObject obj(gzip_path);
+    benchmark::DoNotOptimize(obj.GetId());
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          std::filesystem::file_size(path));
+  std::filesystem::remove(gzip_path);
+}
+BENCHMARK(BM_LoadLargeObjGzip)->Unit(benchmark::kMillisecond)->Iterations(3);
+
+// The same grid as OBJ text, binary STL (welded on load) and binary PLY
+static void BM_LoadFormat(benchmark::State &state) {
+  auto format = static_cast<s21::MeshFormatT>(state.range(0));
+  std::string path = WriteGridAs(format);
+  std::size_t faces = 0;
+  for (auto _ : state) {
+    s21::WireframeObject obj(path);
+    faces = obj.GetFaceCount();
+  }
+  state.counters["faces_per_second"] = benchmark::Counter(
+      static_cast<double>(faces * state.iterations()),
+      benchmark::Counter::kIsRate);
+  state.SetBytesProcessed(state.iterations() *
+                          std::filesystem::file_size(path));
+  if (format != s21::kFormatObj) std::filesystem::remove(path);
+}
+BENCHMARK(BM_LoadFormat)
+    ->ArgName("format")
+    ->Arg(s21::kFormatObj)
+    ->Arg(s21::kFormatStl)
+    ->Arg(s21::kFormatPly)
+    ->Arg(s21::kFormatGltf)
+    ->Unit(benchmark::kMillisecond)
+    ->Iterations(3)
+    ->UseRealTime();
+
+// Welding the large sample written as a triangle soup, three vertices per
+// face, back into the shared mesh
+static void BM_WeldVertices(benchmark::State &state) {
+  s21::WireframeObject grid(LargeSamplePath());
+  std::vector<s21::Coordinate> soup;
+  soup.reserve(grid.GetFaceCount() * 3);
+  for (const s21::Face &face : grid.GetFaces()) {
+    for (std::uint32_t index : face.index) {
+      soup.push_back(grid.GetVertices()[index]);
+    }
+  }
+  // Tolerance 0 = exact matches, otherwise in millionths of a unit; the
+  // grid spacing is a thousandth
+  float epsilon = state.range(0) * 1e-6f;
+  unsigned threads = static_cast<unsigned>(state.range(1));
+  std::size_t welded_count = 0;
+  for (auto _ : state) {
+    s21::ArenaVector<s21::Coordinate> welded;
+    std::vector<std::uint64_t> remap;
+    s21::WeldPositions(soup, epsilon, threads, welded, remap);
+    welded_count = welded.size();
+  }
+  state.counters["vertices_before"] = static_cast<double>(soup.size());
+  state.counters["vertices_after"] = static_cast<double>(welded_count);
+}
+BENCHMARK(BM_WeldVertices)
+    ->ArgNames({"tolerance", "threads"})
+    ->Args({0, 1})
+    ->Args({0, 4})
+    ->Args({1, 1})
+    ->Args({1, 4})
+    ->Unit(benchmark::kMillisecond)
+    ->Iterations(3)
+    ->UseRealTime();
+
+// Unique edges of the large sample: every face edge is packed, sorted and
+// deduplicated, about two faces share each edge
+static void BM_BuildEdgeList(benchmark::State &state) {
+  s21::WireframeObject grid(LargeSamplePath());
+  unsigned threads = static_cast<unsigned>(state.range(0));
+  std::size_t edge_count = 0;
+  for (auto _ : state) {
+    s21::ArenaVector<s21::Edge> edges;
+    s21::BuildEdgeList(grid.GetFaces(), grid.GetFaceEdges(),
+                       grid.GetVertexCount(), threads, edges);
+    edge_count = edges.size();
+  }
+  state.counters["face_edges"] =
+      static_cast<double>(grid.GetFaceCount() * 3);
+  state.counters["edges"] = static_cast<double>(edge_count);
+}
+BENCHMARK(BM_BuildEdgeList)
+    ->ArgName("threads")
+    ->Arg(1)
+    ->Arg(4)
+    ->Unit(benchmark::kMillisecond)
+    ->Iterations(3)
+    ->UseRealTime();
+
+// Level of detail chain of the large sample, each level clustered from the
+// one before it
+static void BM_BuildLodChain(benchmark::State &state) {
+  s21::WireframeObject grid(LargeSamplePath());
+  unsigned threads = static_cast<unsigned>(state.range(0));
+  std::vector<s21::MeshLod> chain;
+  for (auto _ : state) {
+    chain = s21::BuildLodChain(grid, threads);
+  }
+  state.counters["levels"] = static_cast<double>(chain.size());
+  state.counters["first_level_faces"] =
+      chain.empty() ? 0.0 : static_cast<double>(chain.front().faces.size());
+}
+BENCHMARK(BM_BuildLodChain)
+    ->ArgName("threads")
+    ->Arg(1)
+    ->Arg(4)
+    ->Unit(benchmark::kMillisecond)
+    ->Iterations(3)
+    ->UseRealTime();
+
+// Heap allocations of one load: with the arena they stay flat as the file
+// grows, without it every array reallocates as it doubles
+static void BM_LoadAllocations(benchmark::State &state) {
+  std::string path = WriteGridSample(static_cast<int>(state.range(0)));
+  s21::LoadOptions options;
+  options.contiguous_mesh = state.range(1) != 0;
+  options.thread_count = static_cast<unsigned>(state.range(2));
+  std::size_t allocations = s21::AllocationCount();
+  for (auto _ : state) {
+    s21::WireframeObject obj(path, options);
+    benchmark::DoNotOptimize(obj.GetId());
+  }
+  allocations = s21::AllocationCount() - allocations;
+  state.counters["allocs_per_load"] = benchmark::Counter(
+      static_cast<double>(allocations), benchmark::Counter::kAvgIterations);
+  std::filesystem::remove(path);
+}
+BENCHMARK(BM_LoadAllocations)
+    ->ArgNames({"side", "contiguous", "threads"})
+    ->ArgsProduct({{250, 500, 1000}, {0, 1}, {1, 4}})
+    ->Unit(benchmark::kMillisecond)
+    ->Iterations(3);
@@ -0,0 +1,71 @@
+#include <benchmark/benchmark.h>
+
+#include <sstream>
+#include <string>
+
+#include "model/obj_chunk.h"
+#include "model/simd_scanner.h"
+
+namespace {
+
+const int kLineCount = 1000000;
+
+const std::string &ObjLines() {
+  static const std::string lines = [] {
+    std::ostringstream oss;
+    for (int i = 1; i <= kLineCount; ++i) {
+      if (i % 3 == 0) {
+        // Only vertices that were already read may be referenced
+        int last = i * 2 / 3;
+        oss << "f " << last - 1 << ' ' << last << ' ' << last / 2 + 1 << '\n';
+      } else {
+        oss << "v " << i * 0.001f << ' ' << -i * 0.002f << " 0.5\n";
+      }
+    }
+    return oss.str();
+  }();
+  return lines;
+}
+
+}  // namespace
+
+// Reference: one string_view::find (memchr) per line
+static void BM_SplitLinesFind(benchmark::State &state) {
+  ObjLines();
+  for (auto _ : state) {
+    std::string_view buffer = ObjLines();
+    while (!buffer.empty()) {
+      size_t line_end = buffer.find('\n');
+      benchmark::DoNotOptimize(buffer.substr(0, line_end));
+      buffer.remove_prefix(line_end == std::string_view::npos ? buffer.size()
+                                                              : line_end + 1);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kLineCount);
+  state.SetBytesProcessed(state.iterations() * ObjLines().size());
+}
+BENCHMARK(BM_SplitLinesFind);
+
+static void BM_SplitLinesScanner(benchmark::State &state) {
+  ObjLines();
+  for (auto _ : state) {
+    s21::LineScanner scanner(ObjLines());
+    std::string_view line;
+    while (scanner.Next(line)) benchmark::DoNotOptimize(line);
+  }
+  state.SetItemsProcessed(state.iterations() * kLineCount);
+  state.SetBytesProcessed(state.iterations() * ObjLines().size());
+}
+BENCHMARK(BM_SplitLinesScanner);
+
+// Line splitting, prefix dispatch and number parsing together
+static void BM_ParseChunk(benchmark::State &state) {
+  ObjLines();
+  for (auto _ : state) {
+    s21::ObjChunk chunk;
+    benchmark::DoNotOptimize(chunk.Parse(ObjLines()));
+  }
+  state.SetItemsProcessed(state.iterations() * kLineCount);
+  state.SetBytesProcessed(state.iterations() * ObjLines().size());
+}
+BENCHMARK(BM_ParseChunk)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,105 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+
+#include "model/obj_tokenizer.h"
+
+namespace {
+
+const int kTokenCount = 100000;
+
+const std::string &FloatTokens() {
+  static const std::string tokens = [] {
+    std::ostringstream oss;
+    for (int i = 0; i < kTokenCount; ++i) {
+      oss << (i % 2000) * 0.0137f - 9 << ' ';
+    }
+    return oss.str();
+  }();
+  return tokens;
+}
+
+const std::string &CornerTokens() {
+  static const std::string tokens = [] {
+    std::ostringstream oss;
+    for (int i = 1; i <= kTokenCount; ++i) {
+      oss << i << '/' << i % 977 + 1 << '/' << i % 131 + 1 << ' ';
+    }
+    return oss.str();
+  }();
+  return tokens;
+}
+
+}  // namespace
+
+// Reference: operator>> on an istringstream, as the parser did originally
+static void BM_FloatStream(benchmark::State &state) {
+  for (auto _ : state) {
+    std::istringstream iss(FloatTokens());
+    float value = 0.0f;
+    while (iss >> value) benchmark::DoNotOptimize(value);
+  }
+  state.SetItemsProcessed(state.iterations() * kTokenCount);
+}
+BENCHMARK(BM_FloatStream);
+
+// Reference: strtof on a stack copy of each token
+static void BM_FloatStrtof(benchmark::State &state) {
+  for (auto _ : state) {
+    s21::ObjTokenizer tokenizer(FloatTokens());
+    for (std::string_view token = tokenizer.NextToken(); !token.empty();
+         token = tokenizer.NextToken()) {
+      char buffer[64];
+      token.copy(buffer, token.size());
+      buffer[token.size()] = '\0';
+      benchmark::DoNotOptimize(std::strtof(buffer, nullptr));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kTokenCount);
+}
+BENCHMARK(BM_FloatStrtof);
+
+static void BM_FloatFromChars(benchmark::State &state) {
+  for (auto _ : state) {
+    s21::ObjTokenizer tokenizer(FloatTokens());
+    float value = 0.0f;
+    while (tokenizer.NextFloat(value)) benchmark::DoNotOptimize(value);
+  }
+  state.SetItemsProcessed(state.iterations() * kTokenCount);
+}
+BENCHMARK(BM_FloatFromChars);
+
+// Reference: count slashes, then sscanf, as the parser did originally
+static void BM_FaceCornerSscanf(benchmark::State &state) {
+  for (auto _ : state) {
+    std::istringstream iss(CornerTokens());
+    std::string vertex_data;
+    while (iss >> vertex_data) {
+      int v_idx = 0, vt_idx = 0, vn_idx = 0;
+      size_t slash_count =
+          std::count(vertex_data.begin(), vertex_data.end(), '/');
+      if (slash_count == 2) {
+        sscanf(vertex_data.c_str(), "%d/%d/%d", &v_idx, &vt_idx, &vn_idx);
+      }
+      benchmark::DoNotOptimize(v_idx + vt_idx + vn_idx);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kTokenCount);
+}
+BENCHMARK(BM_FaceCornerSscanf);
+
+static void BM_FaceCornerFromChars(benchmark::State &state) {
+  for (auto _ : state) {
+    s21::ObjTokenizer tokenizer(CornerTokens());
+    s21::FaceCorner corner;
+    while (tokenizer.NextFaceCorner(corner)) {
+      benchmark::DoNotOptimize(corner.v + corner.vt + corner.vn);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kTokenCount);
+}
+BENCHMARK(BM_FaceCornerFromChars);
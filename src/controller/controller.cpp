@@ -3,22 +3,68 @@
 
 namespace s21 {
 void ViewerWidget::OpenFile() {
-  QString file_path = QFileDialog::getOpenFileName(this, "Open Object File", "",
-                                                   "Object Files (*.obj)");
-  if (file_path != nullptr)
-    current_object_ =
-        std::make_shared<WireframeObject>(file_path.toStdString());
-  UpdateObjectInfo();
+  // The loader registry lists every format it can read
+  QString file_path = QFileDialog::getOpenFileName(
+      this, "Open Object File", "",
+      QString::fromStdString(MeshFormatFilter()));
+  if (file_path == nullptr) return;
+
+  // Parsing runs on a worker thread, the current model stays on screen and
+  // interactive until the first part of the new one arrives. Reopening an
+  // unchanged file is served from the binary mesh cache.
+  LoadOptions options;
+  options.use_cache = true;
+  options.weld_tolerance =
+      SettingsFacade::GetInstance()->weld_tolerance_.GetOption();
+  // A load replaced before it finished leaves its preview behind
+  if (main_viewer_->IsStreaming()) main_viewer_->SetModel(current_object_);
+  model_loader_->Start(file_path.toStdString(), options);
+  SetLoadingState(true);
+}
+
+void ViewerWidget::CancelLoading() { model_loader_->Cancel(); }
+
+void ViewerWidget::OnLoadProgress(quint64 bytes_processed, quint64 total_bytes,
+                                  quint64 records_parsed) {
+  int step = total_bytes == 0
+                 ? 0
+                 : static_cast<int>(std::min<quint64>(bytes_processed,
+                                                      total_bytes) *
+                                    kLoadProgressSteps / total_bytes);
+  load_progress_bar_->setValue(step);
+  load_progress_bar_->setFormat(
+      QString("%p% (%1 records)").arg(records_parsed));
+}
+
+void ViewerWidget::OnBatchesReady() {
+  main_viewer_->AppendBatches(model_loader_->TakeBatches());
+}
+
+void ViewerWidget::OnModelLoaded(std::shared_ptr<WireframeObject> model) {
+  SetLoadingState(false);
+  current_object_ = std::move(model);
+  UpdateObjectInfo(true);
+}
+
+void ViewerWidget::OnLoadFailed() {
+  SetLoadingState(false);
+  // Put back the model the partial preview replaced
+  if (main_viewer_->IsStreaming()) main_viewer_->SetModel(current_object_);
+  ShowError();
+}
+
+void ViewerWidget::OnLoadCancelled() {
+  SetLoadingState(false);
+  if (main_viewer_->IsStreaming()) main_viewer_->SetModel(current_object_);
+  log_viewer_->append(
+      QString::fromStdString(GetStatusMessage(load_cancelled)));
 }
 
 void Scene::wheelEvent(QWheelEvent* event) {
   // Увеличиваем или уменьшаем масштаб в зависимости от направления прокрутки
-  if (event->angleDelta().y() > 0) {
-    scale_factor_ *= 1.1f;  // Увеличение
-  } else {
-    scale_factor_ /= 1.1f;  // Уменьшение
-  }
-  update();
+  pending_zoom_steps_ += event->angleDelta().y() > 0 ? 1 : -1;
+  interaction_timer_->start();
+  RequestRedraw();
 }
 
 void Scene::mousePressEvent(QMouseEvent* event) {
@@ -32,15 +78,26 @@ void Scene::mousePressEvent(QMouseEvent* event) {
 }
 
 void Scene::mouseMoveEvent(QMouseEvent* event) {
+  // Only the deltas are collected here, the next frame applies them
   if (is_dragging_) {
-    // Вычисляем смещение мыши
     QPoint delta = event->pos() - last_mouse_pos_;
     last_mouse_pos_ = event->pos();
+    pending_drag_ += QVector2D(delta.x(), delta.y());
+    RequestRedraw();
+  } else if (is_rotating_) {
+    QPoint delta = event->pos() - last_rotate_pos_;
+    last_rotate_pos_ = event->pos();
+    pending_rotation_ += QVector2D(delta.x(), delta.y());
+    RequestRedraw();
+  }
+}
 
-    const float kBaseSensitivity = 0.005f;
-    const float kMinSensitivity = 0.00001f;
-    const float kMaxSensitivity = 0.1f;
-
+void Scene::ApplyPendingInput() {
+  if (pending_zoom_steps_ != 0) {
+    scale_factor_ *= std::pow(1.1f, static_cast<float>(pending_zoom_steps_));
+    pending_zoom_steps_ = 0;
+  }
+  if (!pending_drag_.isNull()) {
     // Чувствительность обратно пропорциональна масштабу
     float effective_sensitivity = kBaseSensitivity / scale_factor_;
 
@@ -48,16 +105,16 @@ void Scene::mouseMoveEvent(QMouseEvent* event) {
     effective_sensitivity =
         qBound(kMinSensitivity, effective_sensitivity, kMaxSensitivity);
 
-    // -delta.y() потому что ось Y направлена вниз а в OpenGL - вверх
-    model_position_ += QVector2D(delta.x(), -delta.y()) * effective_sensitivity;
-    update();
-  } else if (is_rotating_) {
-    QPoint delta = event->pos() - last_rotate_pos_;
-    last_rotate_pos_ = event->pos();
-
+    // -y потому что ось Y направлена вниз а в OpenGL - вверх
+    model_position_ += QVector2D(pending_drag_.x(), -pending_drag_.y()) *
+                       effective_sensitivity;
+    pending_drag_ = QVector2D();
+  }
+  if (!pending_rotation_.isNull()) {
     // Обновляем углы поворота
-    rotation_angles_.setY(rotation_angles_.y() + delta.x() * 0.5f);
-    rotation_angles_.setX(rotation_angles_.x() + delta.y() * 0.5f);
+    rotation_angles_.setY(rotation_angles_.y() + pending_rotation_.x() * 0.5f);
+    rotation_angles_.setX(rotation_angles_.x() + pending_rotation_.y() * 0.5f);
+    pending_rotation_ = QVector2D();
 
     // Создаем матрицы поворота
     S21Matrix rotX = CreateRotationMatrix('X', rotation_angles_.x());
@@ -65,8 +122,6 @@ void Scene::mouseMoveEvent(QMouseEvent* event) {
 
     // Комбинируем повороты: сначала Y, потом X
     rotation_matrix_ = rotY * rotX;
-
-    update();
   }
 }
 
@@ -101,9 +156,14 @@ S21Matrix Scene::CreateRotationMatrix(char axis, float angle) {
 }
 
 void Scene::mouseReleaseEvent(QMouseEvent* event) {
+  bool was_interacting = is_dragging_ || is_rotating_;
   if (event->button() == Qt::LeftButton) {
     is_dragging_ = false;
+  } else if (event->button() == Qt::RightButton) {
+    is_rotating_ = false;
   }
+  // Points thinned out during the move are drawn again
+  if (was_interacting) RequestRedraw();
 }
 
 }  // namespace s21
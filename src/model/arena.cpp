@@ -0,0 +1,62 @@
+#include "model/arena.h"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+
+namespace s21 {
+
+Arena::Arena(std::size_t capacity) {
+  if (capacity == 0) return;
+  capacity = (capacity + kArenaHugePageBytes - 1) / kArenaHugePageBytes *
+             kArenaHugePageBytes;
+  // Address space only: nothing is committed until it is written
+  std::size_t mapping_size = capacity + kArenaHugePageBytes;
+  void *mapping =
+      mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE,
+           MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (mapping == MAP_FAILED) return;
+  mapping_ = mapping;
+  mapping_size_ = mapping_size;
+  std::uintptr_t address = reinterpret_cast<std::uintptr_t>(mapping);
+  base_ = reinterpret_cast<char *>(
+      (address + kArenaHugePageBytes - 1) / kArenaHugePageBytes *
+      kArenaHugePageBytes);
+  capacity_ = capacity;
+#ifdef MADV_HUGEPAGE
+  madvise(base_, capacity_, MADV_HUGEPAGE);
+#endif
+}
+
+Arena::~Arena() {
+  if (mapping_ != nullptr) munmap(mapping_, mapping_size_);
+}
+
+void *Arena::Allocate(std::size_t bytes, std::size_t alignment) {
+  alignment = std::max(alignment, kArenaAlignment);
+  std::size_t used = used_.load();
+  std::size_t start = 0;
+  do {
+    start = (used + alignment - 1) / alignment * alignment;
+    if (!IsReserved() || start > capacity_ || bytes > capacity_ - start) {
+      throw std::bad_alloc();
+    }
+  } while (!used_.compare_exchange_weak(used, start + bytes));
+  return base_ + start;
+}
+
+void Arena::Deallocate(void *data, std::size_t bytes) {
+  if (bytes < kArenaReleaseBytes) return;
+  // Only pages lying entirely inside the block may be dropped
+  std::size_t page = static_cast<std::size_t>(sysconf(_SC_PAGE_SIZE));
+  std::uintptr_t begin = reinterpret_cast<std::uintptr_t>(data);
+  std::uintptr_t first = (begin + page - 1) / page * page;
+  std::uintptr_t last = (begin + bytes) / page * page;
+  if (last > first) {
+    madvise(reinterpret_cast<void *>(first), last - first, MADV_DONTNEED);
+  }
+}
+
+}  // namespace s21
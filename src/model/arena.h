@@ -0,0 +1,114 @@
+#ifndef MODEL_ARENA_H
+#define MODEL_ARENA_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace s21 {
+// Every allocation starts on a cache line
+const std::size_t kArenaAlignment = 64;
+// The reservation is aligned so the kernel can back it with huge pages
+const std::size_t kArenaHugePageBytes = 2 << 20;
+// Freed blocks at least this big give their pages back to the system
+const std::size_t kArenaReleaseBytes = 1 << 20;
+
+/**
+ * @class Arena
+ * @brief Bump allocator over one reserved, huge-page friendly address range
+ *
+ * The whole range is reserved up front without committing memory, so the
+ * arena never allocates again: Allocate() only moves an offset forward and
+ * pages become resident when they are first written. Freed blocks are not
+ * reused, large ones hand their pages back to the system instead. Allocate()
+ * may be called from several threads at once and throws std::bad_alloc when
+ * the range is exhausted.
+ */
+class Arena {
+ public:
+  explicit Arena(std::size_t capacity);
+  ~Arena();
+  Arena(const Arena &) = delete;
+  Arena &operator=(const Arena &) = delete;
+
+  bool IsReserved() const { return base_ != nullptr; }
+  void *Allocate(std::size_t bytes, std::size_t alignment);
+  void Deallocate(void *data, std::size_t bytes);
+  // Part of the range handed out so far, freed blocks included
+  std::size_t GetUsedBytes() const { return used_.load(); }
+  std::size_t GetCapacity() const { return capacity_; }
+  bool Contains(const void *data) const {
+    const char *byte = static_cast<const char *>(data);
+    return byte >= base_ && byte < base_ + capacity_;
+  }
+
+ private:
+  char *base_{nullptr};
+  std::size_t capacity_{0};
+  // Whole mapping including the alignment slack, for munmap
+  void *mapping_{nullptr};
+  std::size_t mapping_size_{0};
+  std::atomic<std::size_t> used_{0};
+};  // class Arena
+
+/**
+ * @class ArenaAllocator
+ * @brief Standard allocator drawing from an Arena, or from the heap when it
+ * has none
+ *
+ * Containers moved between owners take their arena along. Copies are made
+ * on the heap, so they never depend on the lifetime of someone else's arena.
+ */
+template <typename T>
+class ArenaAllocator {
+ public:
+  using value_type = T;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+
+  ArenaAllocator() = default;
+  explicit ArenaAllocator(Arena *arena) : arena_(arena) {}
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U> &other) : arena_(other.GetArena()) {}
+
+  T *allocate(std::size_t count) {
+    if (arena_ == nullptr) return std::allocator<T>().allocate(count);
+    if (count > SIZE_MAX / sizeof(T)) throw std::bad_alloc();
+    return static_cast<T *>(arena_->Allocate(count * sizeof(T), alignof(T)));
+  }
+  void deallocate(T *data, std::size_t count) {
+    if (arena_ == nullptr) {
+      std::allocator<T>().deallocate(data, count);
+    } else {
+      arena_->Deallocate(data, count * sizeof(T));
+    }
+  }
+  ArenaAllocator select_on_container_copy_construction() const {
+    return ArenaAllocator();
+  }
+
+  Arena *GetArena() const { return arena_; }
+  template <typename U>
+  bool operator==(const ArenaAllocator<U> &other) const {
+    return arena_ == other.GetArena();
+  }
+
+ private:
+  Arena *arena_{nullptr};
+};  // class ArenaAllocator
+
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+// Frees the storage of a vector but keeps its allocator
+template <typename T>
+void ReleaseStorage(ArenaVector<T> &values) {
+  values.clear();
+  values.shrink_to_fit();
+}
+}  // namespace s21
+
+#endif  // MODEL_ARENA_H
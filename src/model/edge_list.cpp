@@ -0,0 +1,126 @@
+#include "model/edge_list.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "model/parallel.h"
+
+namespace s21 {
+namespace {
+// Calls emit(key) for every edge of the faces in one block
+template <typename Emit>
+void ForEachEdgeKey(std::span<const Face> faces,
+                    std::span<const FaceEdgeMask> face_edges,
+                    std::size_t block, Emit emit) {
+  bool has_masks = face_edges.size() == faces.size();
+  std::size_t end = std::min(faces.size(), (block + 1) * kEdgeBlockFaces);
+  for (std::size_t i = block * kEdgeBlockFaces; i < end; ++i) {
+    FaceEdgeMask mask = has_masks ? face_edges[i] : kAllFaceEdges;
+    for (int k = 0; k < 3; ++k) {
+      std::uint64_t a = faces[i].index[k];
+      std::uint64_t b = faces[i].index[(k + 1) % 3];
+      if ((mask >> k & 1) == 0 || a == b) continue;
+      emit(std::min(a, b) << 32 | std::max(a, b));
+    }
+  }
+}
+
+// Sorts the keys of edges whose smaller vertex is in [first_vertex,
+// last_vertex) and drops repeats, returns how many are left. A counting sort
+// by the smaller vertex leaves a few keys per vertex to sort by the other.
+std::uint64_t SortUniqueKeys(std::uint64_t *begin, std::uint64_t *end,
+                             std::uint64_t first_vertex,
+                             std::uint64_t last_vertex) {
+  std::vector<std::uint64_t> starts(last_vertex - first_vertex + 1, 0);
+  for (const std::uint64_t *key = begin; key != end; ++key) {
+    ++starts[(*key >> 32) - first_vertex + 1];
+  }
+  for (std::size_t i = 1; i < starts.size(); ++i) starts[i] += starts[i - 1];
+  std::vector<std::uint64_t> sorted(end - begin);
+  for (const std::uint64_t *key = begin; key != end; ++key) {
+    sorted[starts[(*key >> 32) - first_vertex]++] = *key;
+  }
+
+  // Every start moved to the end of its vertex's keys
+  std::uint64_t *out = begin;
+  auto group_begin = sorted.begin();
+  for (std::size_t i = 0; i + 1 < starts.size(); ++i) {
+    auto group_end = sorted.begin() + starts[i];
+    std::sort(group_begin, group_end);
+    out = std::unique_copy(group_begin, group_end, out);
+    group_begin = group_end;
+  }
+  return out - begin;
+}
+}  // namespace
+
+void BuildEdgeList(std::span<const Face> faces,
+                   std::span<const FaceEdgeMask> face_edges,
+                   std::size_t vertex_count, unsigned thread_count,
+                   ArenaVector<Edge> &edges) {
+  edges.clear();
+  if (faces.empty() || vertex_count == 0) return;
+  std::size_t bucket_count = std::min(
+      ResolveThreadCount(thread_count) * kEdgeBucketsPerThread, vertex_count);
+  std::size_t block_count =
+      (faces.size() + kEdgeBlockFaces - 1) / kEdgeBlockFaces;
+  // Keys of the same bucket stay together, ordered by block
+  auto bucket_of = [&](std::uint64_t key) {
+    return static_cast<std::size_t>((key >> 32) * bucket_count /
+                                    vertex_count);
+  };
+
+  std::vector<std::uint64_t> cursors(block_count * bucket_count, 0);
+  ParallelFor(block_count, thread_count, [&](std::size_t block) {
+    std::uint64_t *counts = &cursors[block * bucket_count];
+    ForEachEdgeKey(faces, face_edges, block,
+                   [&](std::uint64_t key) { ++counts[bucket_of(key)]; });
+  });
+  std::vector<std::uint64_t> bucket_starts(bucket_count + 1, 0);
+  std::uint64_t key_count = 0;
+  for (std::size_t bucket = 0; bucket < bucket_count; ++bucket) {
+    bucket_starts[bucket] = key_count;
+    for (std::size_t block = 0; block < block_count; ++block) {
+      std::uint64_t count = cursors[block * bucket_count + bucket];
+      cursors[block * bucket_count + bucket] = key_count;
+      key_count += count;
+    }
+  }
+  bucket_starts[bucket_count] = key_count;
+
+  std::vector<std::uint64_t> keys(key_count);
+  ParallelFor(block_count, thread_count, [&](std::size_t block) {
+    std::uint64_t *next = &cursors[block * bucket_count];
+    ForEachEdgeKey(faces, face_edges, block, [&](std::uint64_t key) {
+      keys[next[bucket_of(key)]++] = key;
+    });
+  });
+
+  std::vector<std::uint64_t> edge_starts(bucket_count + 1, 0);
+  ParallelFor(bucket_count, thread_count, [&](std::size_t bucket) {
+    std::uint64_t *begin = keys.data() + bucket_starts[bucket];
+    std::uint64_t *end = keys.data() + bucket_starts[bucket + 1];
+    std::uint64_t first_vertex =
+        (bucket * vertex_count + bucket_count - 1) / bucket_count;
+    std::uint64_t last_vertex =
+        ((bucket + 1) * vertex_count + bucket_count - 1) / bucket_count;
+    edge_starts[bucket + 1] =
+        SortUniqueKeys(begin, end, first_vertex, last_vertex);
+  });
+  for (std::size_t bucket = 0; bucket < bucket_count; ++bucket) {
+    edge_starts[bucket + 1] += edge_starts[bucket];
+  }
+
+  edges.resize(edge_starts[bucket_count]);
+  ParallelFor(bucket_count, thread_count, [&](std::size_t bucket) {
+    std::uint64_t count = edge_starts[bucket + 1] - edge_starts[bucket];
+    for (std::uint64_t i = 0; i < count; ++i) {
+      std::uint64_t key = keys[bucket_starts[bucket] + i];
+      edges[edge_starts[bucket] + i] = {
+          {static_cast<std::uint32_t>(key >> 32),
+           static_cast<std::uint32_t>(key)}};
+    }
+  });
+}
+}  // namespace s21
@@ -0,0 +1,34 @@
+#ifndef MODEL_EDGE_LIST_H
+#define MODEL_EDGE_LIST_H
+
+#include <span>
+
+#include "model/arena.h"
+#include "model/mesh_types.h"
+
+namespace s21 {
+// Faces whose edges one thread packs at a time
+const std::size_t kEdgeBlockFaces = 1 << 16;
+// Vertex ranges per thread the keys are sorted in; more ranges than threads
+// even out ranges with more edges than others
+const std::size_t kEdgeBucketsPerThread = 4;
+
+/**
+ * @brief Lists every edge of the triangles once, laid out for GL_LINES
+ *
+ * Each triangle edge is packed into a 64-bit key of its smaller and larger
+ * vertex index, so an edge shared by two faces gives the same key. Where
+ * face_edges holds a mask per face, only the outline edges it marks are
+ * taken. Keys are scattered into ranges of their smaller vertex, then every
+ * range is counting-sorted and deduplicated on its own thread. The edges
+ * come out ordered by their first, then second vertex whatever the thread
+ * count. Edges with both ends on one vertex are dropped. Running out of
+ * memory on any thread throws std::bad_alloc on the calling one.
+ */
+void BuildEdgeList(std::span<const Face> faces,
+                   std::span<const FaceEdgeMask> face_edges,
+                   std::size_t vertex_count, unsigned thread_count,
+                   ArenaVector<Edge> &edges);
+}  // namespace s21
+
+#endif  // MODEL_EDGE_LIST_H
@@ -29,6 +29,8 @@ std::string GetStatusMessage(ErrorCode status) {
       return "Invalid file format";
     case ErrorCode::memory_error:
       return "Memory allocation error";
+    case ErrorCode::load_cancelled:
+      return "Loading cancelled";
     default:
       return "Unknown error";
   }
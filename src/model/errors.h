@@ -15,7 +15,8 @@ typedef enum {
   file_not_found,
   invalid_format,
   memory_error,
-  unknown_error
+  unknown_error,
+  load_cancelled
 } ErrorCode;
 
 void LogError(const std::string& component, const std::string& message);
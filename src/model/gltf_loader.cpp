@@ -0,0 +1,576 @@
+#include "model/gltf_loader.h"
+
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "model/mapped_file.h"
+#include "model/nlohmann/json.hpp"
+
+namespace s21 {
+namespace {
+using Json = nlohmann::json;
+// Column-major, the way glTF stores node matrices
+using Matrix = std::array<float, 16>;
+
+const int kComponentUint8 = 5121;
+const int kComponentUint16 = 5123;
+const int kComponentUint32 = 5125;
+const int kComponentFloat = 5126;
+const int kModeTriangles = 4;
+// Largest byteStride glTF allows
+const std::uint64_t kMaxByteStride = 252;
+const Matrix kIdentity = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1};
+
+struct GltfBuffer {
+  std::string_view data;
+  std::shared_ptr<const void> backing;
+};
+
+// Elements of an accessor, resolved to memory
+struct AccessorView {
+  const char *data = nullptr;
+  std::uint64_t count = 0;
+  std::uint64_t stride = 0;
+  int component_type = 0;
+  std::shared_ptr<const void> backing;
+};
+
+struct MeshInstance {
+  std::size_t mesh = 0;
+  Matrix transform = kIdentity;
+};
+
+struct TrianglePrimitive {
+  AccessorView positions;
+  // Not indexed: every three positions make a triangle
+  bool has_indices = false;
+  AccessorView indices;
+  Matrix transform = kIdentity;
+};
+
+struct GltfMesh {
+  MeshArray<Coordinate> vertices;
+  MeshArray<Face> faces;
+};
+
+std::uint32_t ReadWord(std::string_view data, std::size_t offset) {
+  std::uint32_t word = 0;
+  std::memcpy(&word, data.data() + offset, sizeof(word));
+  return word;
+}
+
+bool ReadGlb(std::string_view file, std::string_view &json,
+             std::string_view &bin, std::string &error) {
+  if (file.size() < kGlbHeaderBytes) {
+    error = "GLB header is truncated";
+    return false;
+  }
+  if (ReadWord(file, 4) != kGlbVersion) {
+    error = "Only glTF 2.0 is supported";
+    return false;
+  }
+  std::size_t length = ReadWord(file, 8);
+  if (length > file.size()) {
+    error = "GLB file is truncated";
+    return false;
+  }
+  json = std::string_view();
+  for (std::size_t position = kGlbHeaderBytes;
+       position + kGlbChunkHeaderBytes <= length;) {
+    std::size_t chunk_length = ReadWord(file, position);
+    std::uint32_t chunk_type = ReadWord(file, position + 4);
+    position += kGlbChunkHeaderBytes;
+    if (chunk_length > length - position) {
+      error = "GLB chunk is truncated";
+      return false;
+    }
+    std::string_view chunk = file.substr(position, chunk_length);
+    if (json.data() == nullptr && chunk_type == kGlbChunkJson) json = chunk;
+    if (bin.data() == nullptr && chunk_type == kGlbChunkBin) bin = chunk;
+    position += chunk_length;
+  }
+  if (json.data() == nullptr) error = "GLB file has no JSON chunk";
+  return json.data() != nullptr;
+}
+
+bool DecodeBase64(std::string_view text, std::string &bytes) {
+  std::uint32_t bits = 0;
+  int bit_count = 0;
+  bytes.reserve(text.size() / 4 * 3);
+  for (char c : text) {
+    std::uint32_t value = 0;
+    if (c >= 'A' && c <= 'Z') {
+      value = c - 'A';
+    } else if (c >= 'a' && c <= 'z') {
+      value = c - 'a' + 26;
+    } else if (c >= '0' && c <= '9') {
+      value = c - '0' + 52;
+    } else if (c == '+' || c == '/') {
+      value = c == '+' ? 62 : 63;
+    } else if (c == '=') {
+      break;
+    } else {
+      return false;
+    }
+    bits = (bits << 6) | value;
+    bit_count += 6;
+    if (bit_count >= 8) {
+      bit_count -= 8;
+      bytes.push_back(static_cast<char>((bits >> bit_count) & 0xff));
+    }
+  }
+  return true;
+}
+
+bool LoadBuffers(const Json &document, const std::string &file_path,
+                 std::string_view bin, const std::shared_ptr<const void> &file,
+                 std::vector<GltfBuffer> &buffers, std::string &error) {
+  if (!document.contains("buffers")) return true;
+  std::filesystem::path directory =
+      std::filesystem::path(file_path).parent_path();
+  for (const Json &buffer : document.at("buffers")) {
+    std::uint64_t length = buffer.at("byteLength").get<std::uint64_t>();
+    GltfBuffer loaded;
+    if (!buffer.contains("uri")) {
+      // Only the first buffer of a .glb may live in its BIN chunk
+      if (!buffers.empty() || bin.data() == nullptr) {
+        error = "Buffer " + std::to_string(buffers.size()) + " has no uri";
+        return false;
+      }
+      loaded = {bin, file};
+    } else {
+      std::string uri = buffer.at("uri").get<std::string>();
+      if (uri.starts_with("data:")) {
+        std::size_t start = uri.find(";base64,");
+        auto decoded = std::make_shared<std::string>();
+        if (start == std::string::npos ||
+            !DecodeBase64(std::string_view(uri).substr(start + 8),
+                          *decoded)) {
+          error = "Buffer data URI is not base64";
+          return false;
+        }
+        loaded = {*decoded, decoded};
+      } else {
+        auto external =
+            std::make_shared<const MappedFile>((directory / uri).string());
+        if (!external->IsMapped()) {
+          error = "Buffer file not found: " + uri;
+          return false;
+        }
+        loaded = {external->GetView(), external};
+      }
+    }
+    if (loaded.data.size() < length) {
+      error = "Buffer " + std::to_string(buffers.size()) +
+              " is shorter than its byteLength";
+      return false;
+    }
+    loaded.data = loaded.data.substr(0, length);
+    buffers.push_back(loaded);
+  }
+  return true;
+}
+
+std::uint64_t ComponentBytes(int component_type) {
+  switch (component_type) {
+    case kComponentUint8:
+      return 1;
+    case kComponentUint16:
+      return 2;
+    case kComponentUint32:
+    case kComponentFloat:
+      return 4;
+    default:
+      return 0;
+  }
+}
+
+bool ResolveAccessor(const Json &document,
+                     const std::vector<GltfBuffer> &buffers,
+                     std::size_t index, const std::string &type,
+                     AccessorView &view, std::string &error) {
+  const Json &accessor = document.at("accessors").at(index);
+  std::string name = "Accessor " + std::to_string(index);
+  if (accessor.at("type").get<std::string>() != type) {
+    error = name + " is not a " + type;
+    return false;
+  }
+  if (accessor.contains("sparse") || !accessor.contains("bufferView")) {
+    error = name + " has no plain buffer data";
+    return false;
+  }
+  view.component_type = accessor.at("componentType").get<int>();
+  std::uint64_t element_bytes =
+      ComponentBytes(view.component_type) * (type == "VEC3" ? 3 : 1);
+  view.count = accessor.at("count").get<std::uint64_t>();
+  const Json &buffer_view =
+      document.at("bufferViews").at(accessor.at("bufferView").get<std::size_t>());
+  std::uint64_t buffer = buffer_view.at("buffer").get<std::uint64_t>();
+  std::uint64_t view_offset = buffer_view.value("byteOffset", std::uint64_t{0});
+  std::uint64_t view_length = buffer_view.at("byteLength").get<std::uint64_t>();
+  view.stride = buffer_view.value("byteStride", element_bytes);
+  std::uint64_t offset = accessor.value("byteOffset", std::uint64_t{0});
+  if (element_bytes == 0 || view.stride < element_bytes ||
+      view.stride > kMaxByteStride || buffer >= buffers.size()) {
+    error = name + " has an unsupported layout";
+    return false;
+  }
+
+  // The last element must end inside the view, and the view in the buffer
+  std::string_view data = buffers[buffer].data;
+  std::uint64_t available = view_length - offset;
+  if (view_offset > data.size() || view_length > data.size() - view_offset ||
+      offset > view_length ||
+      (view.count != 0 &&
+       (element_bytes > available ||
+        view.count - 1 > (available - element_bytes) / view.stride))) {
+    error = name + " reaches past its buffer";
+    return false;
+  }
+  view.data = data.data() + view_offset + offset;
+  view.backing = buffers[buffer].backing;
+  return true;
+}
+
+Matrix Multiply(const Matrix &a, const Matrix &b) {
+  Matrix result{};
+  for (int column = 0; column < 4; ++column) {
+    for (int row = 0; row < 4; ++row) {
+      for (int k = 0; k < 4; ++k) {
+        result[column * 4 + row] += a[k * 4 + row] * b[column * 4 + k];
+      }
+    }
+  }
+  return result;
+}
+
+// Either the node's matrix or translation * rotation * scale
+Matrix LocalTransform(const Json &node) {
+  if (node.contains("matrix")) return node.at("matrix").get<Matrix>();
+  auto t = node.value("translation", std::array<float, 3>{0, 0, 0});
+  auto q = node.value("rotation", std::array<float, 4>{0, 0, 0, 1});
+  auto s = node.value("scale", std::array<float, 3>{1, 1, 1});
+  float x = q[0], y = q[1], z = q[2], w = q[3];
+  return {(1 - 2 * (y * y + z * z)) * s[0],
+          2 * (x * y + z * w) * s[0],
+          2 * (x * z - y * w) * s[0],
+          0,
+          2 * (x * y - z * w) * s[1],
+          (1 - 2 * (x * x + z * z)) * s[1],
+          2 * (y * z + x * w) * s[1],
+          0,
+          2 * (x * z + y * w) * s[2],
+          2 * (y * z - x * w) * s[2],
+          (1 - 2 * (x * x + y * y)) * s[2],
+          0,
+          t[0],
+          t[1],
+          t[2],
+          1};
+}
+
+// Walks the tree under root depth first, children in order. Nodes form
+// strict trees in glTF: a node reached again, through a second parent or a
+// cycle, makes the file invalid.
+bool CollectNodes(const Json &document, std::size_t root,
+                  std::vector<bool> &visited,
+                  std::vector<MeshInstance> &instances, std::string &error) {
+  const Json &nodes = document.at("nodes");
+  std::vector<std::pair<std::size_t, Matrix>> pending = {{root, kIdentity}};
+  while (!pending.empty()) {
+    auto [index, parent] = pending.back();
+    pending.pop_back();
+    const Json &node = nodes.at(index);
+    if (visited[index]) {
+      error = "Node " + std::to_string(index) + " has more than one parent";
+      return false;
+    }
+    visited[index] = true;
+    Matrix transform = Multiply(parent, LocalTransform(node));
+    if (node.contains("mesh")) {
+      instances.push_back({node.at("mesh").get<std::size_t>(), transform});
+    }
+    Json children = node.value("children", Json::array());
+    for (auto child = children.rbegin(); child != children.rend(); ++child) {
+      pending.push_back({child->get<std::size_t>(), transform});
+    }
+  }
+  return true;
+}
+
+bool CollectInstances(const Json &document,
+                      std::vector<MeshInstance> &instances,
+                      std::string &error) {
+  if (!document.contains("scenes") || !document.contains("nodes")) {
+    // Without a scene every mesh is shown once, as stored
+    std::size_t mesh_count =
+        document.contains("meshes") ? document.at("meshes").size() : 0;
+    for (std::size_t i = 0; i < mesh_count; ++i) instances.push_back({i});
+    return true;
+  }
+  const Json &scene =
+      document.at("scenes").at(document.value("scene", std::size_t{0}));
+  std::vector<bool> visited(document.at("nodes").size(), false);
+  for (const Json &root : scene.value("nodes", Json::array())) {
+    if (!CollectNodes(document, root.get<std::size_t>(), visited, instances,
+                      error)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool CollectPrimitives(const Json &document,
+                       const std::vector<GltfBuffer> &buffers,
+                       const std::vector<MeshInstance> &instances,
+                       std::vector<TrianglePrimitive> &primitives,
+                       std::string &error) {
+  for (const MeshInstance &instance : instances) {
+    const Json &mesh = document.at("meshes").at(instance.mesh);
+    for (const Json &primitive : mesh.at("primitives")) {
+      const Json &attributes = primitive.at("attributes");
+      if (primitive.value("mode", kModeTriangles) != kModeTriangles ||
+          !attributes.contains("POSITION")) {
+        continue;
+      }
+      TrianglePrimitive triangles;
+      triangles.transform = instance.transform;
+      if (!ResolveAccessor(document, buffers,
+                           attributes.at("POSITION").get<std::size_t>(),
+                           "VEC3", triangles.positions, error)) {
+        return false;
+      }
+      if (triangles.positions.component_type != kComponentFloat) {
+        error = "Positions must be floats";
+        return false;
+      }
+      std::uint64_t corners = triangles.positions.count;
+      triangles.has_indices = primitive.contains("indices");
+      if (triangles.has_indices) {
+        if (!ResolveAccessor(document, buffers,
+                             primitive.at("indices").get<std::size_t>(),
+                             "SCALAR", triangles.indices, error)) {
+          return false;
+        }
+        if (triangles.indices.component_type == kComponentFloat) {
+          error = "Indices must be integers";
+          return false;
+        }
+        corners = triangles.indices.count;
+      }
+      if (corners % 3 != 0) {
+        error = "Triangle list has " + std::to_string(corners) + " corners";
+        return false;
+      }
+      primitives.push_back(triangles);
+    }
+  }
+  if (primitives.empty()) error = "File has no triangle meshes";
+  return !primitives.empty();
+}
+
+Coordinate ReadPosition(const AccessorView &view, std::uint64_t i) {
+  Coordinate position;
+  std::memcpy(&position, view.data + i * view.stride, sizeof(position));
+  return position;
+}
+
+std::uint64_t ReadIndex(const AccessorView &view, std::uint64_t i) {
+  const char *data = view.data + i * view.stride;
+  if (view.component_type == kComponentUint8) {
+    return static_cast<unsigned char>(*data);
+  }
+  if (view.component_type == kComponentUint16) {
+    std::uint16_t index = 0;
+    std::memcpy(&index, data, sizeof(index));
+    return index;
+  }
+  std::uint32_t index = 0;
+  std::memcpy(&index, data, sizeof(index));
+  return index;
+}
+
+Coordinate Transform(const Matrix &m, const Coordinate &p) {
+  return {m[0] * p.x + m[4] * p.y + m[8] * p.z + m[12],
+          m[1] * p.x + m[5] * p.y + m[9] * p.z + m[13],
+          m[2] * p.x + m[6] * p.y + m[10] * p.z + m[14]};
+}
+
+// Tightly packed positions and 32-bit indices, aligned and not moved
+bool IsMappable(const TrianglePrimitive &primitive) {
+  auto is_aligned = [](const char *data, std::size_t alignment) {
+    return reinterpret_cast<std::uintptr_t>(data) % alignment == 0;
+  };
+  return primitive.transform == kIdentity && primitive.has_indices &&
+         primitive.positions.stride == sizeof(Coordinate) &&
+         is_aligned(primitive.positions.data, alignof(Coordinate)) &&
+         primitive.indices.component_type == kComponentUint32 &&
+         primitive.indices.stride == sizeof(std::uint32_t) &&
+         is_aligned(primitive.indices.data, alignof(Face));
+}
+
+bool MapPrimitive(const TrianglePrimitive &primitive, GltfMesh &mesh,
+                  std::string &error) {
+  const AccessorView &positions = primitive.positions;
+  const AccessorView &indices = primitive.indices;
+  auto vertices = reinterpret_cast<const Coordinate *>(positions.data);
+  auto faces = reinterpret_cast<const std::uint32_t *>(indices.data);
+  // The renderer must never see out-of-range indices or NaN positions
+  for (std::uint64_t i = 0; i < positions.count; ++i) {
+    if (!vertices[i].IsValid()) {
+      error = "Position " + std::to_string(i) + " is not a number";
+      return false;
+    }
+  }
+  for (std::uint64_t i = 0; i < indices.count; ++i) {
+    if (faces[i] >= positions.count) {
+      error = "Index " + std::to_string(faces[i]) + " is out of range";
+      return false;
+    }
+  }
+  mesh.vertices =
+      MeshArray<Coordinate>(vertices, positions.count, positions.backing);
+  mesh.faces = MeshArray<Face>(reinterpret_cast<const Face *>(faces),
+                               indices.count / 3, indices.backing);
+  return true;
+}
+
+ErrorCode GatherPrimitives(const std::vector<TrianglePrimitive> &primitives,
+                           const LoadOptions &options, GltfMesh &mesh,
+                           std::string &error) {
+  std::uint64_t vertex_count = 0, face_count = 0;
+  for (const TrianglePrimitive &primitive : primitives) {
+    vertex_count += primitive.positions.count;
+    face_count += (primitive.has_indices ? primitive.indices.count
+                                         : primitive.positions.count) /
+                  3;
+  }
+  if (vertex_count >= kNoIndex) {
+    error = "Model has more vertices than 32-bit indices can address";
+    return invalid_format;
+  }
+  std::uint64_t memory_budget = ResolveMemoryBudget(options.memory_budget);
+  if (memory_budget != 0 &&
+      vertex_count * sizeof(Coordinate) + face_count * sizeof(Face) >
+          memory_budget) {
+    error = "Model exceeds the memory budget of " +
+            std::to_string(memory_budget >> 20) + " MB";
+    return memory_error;
+  }
+
+  ArenaVector<Coordinate> vertices;
+  ArenaVector<Face> faces;
+  vertices.reserve(vertex_count);
+  faces.reserve(face_count);
+  for (const TrianglePrimitive &primitive : primitives) {
+    if (options.progress != nullptr && options.progress->IsCancelled()) {
+      return load_cancelled;
+    }
+    const AccessorView &positions = primitive.positions;
+    std::uint32_t base = static_cast<std::uint32_t>(vertices.size());
+    bool is_moved = primitive.transform != kIdentity;
+    for (std::uint64_t i = 0; i < positions.count; ++i) {
+      Coordinate position = ReadPosition(positions, i);
+      if (is_moved) position = Transform(primitive.transform, position);
+      if (!position.IsValid()) {
+        error = "Position " + std::to_string(i) + " is not a number";
+        return invalid_format;
+      }
+      vertices.push_back(position);
+    }
+    std::uint64_t corners = primitive.has_indices ? primitive.indices.count
+                                                  : positions.count;
+    for (std::uint64_t i = 0; i < corners; i += 3) {
+      Face face;
+      for (std::uint64_t k = 0; k < 3; ++k) {
+        std::uint64_t index =
+            primitive.has_indices ? ReadIndex(primitive.indices, i + k)
+                                  : i + k;
+        if (index >= positions.count) {
+          error = "Index " + std::to_string(index) + " is out of range";
+          return invalid_format;
+        }
+        face.index[k] = base + static_cast<std::uint32_t>(index);
+      }
+      faces.push_back(face);
+    }
+  }
+  mesh.vertices = std::move(vertices);
+  mesh.faces = std::move(faces);
+  return success_code;
+}
+
+ErrorCode BuildMesh(const std::shared_ptr<const MappedFile> &file,
+                    const std::string &file_path, const LoadOptions &options,
+                    GltfMesh &mesh, std::string &error) {
+  std::string_view json = file->GetView(), bin;
+  if (HasGlbMagic(json) && !ReadGlb(file->GetView(), json, bin, error)) {
+    return invalid_format;
+  }
+  Json document = Json::parse(json.begin(), json.end());
+  if (!document.at("asset").at("version").get<std::string>().starts_with(
+          "2.")) {
+    error = "Only glTF 2.0 is supported";
+    return invalid_format;
+  }
+  std::vector<GltfBuffer> buffers;
+  std::vector<MeshInstance> instances;
+  std::vector<TrianglePrimitive> primitives;
+  if (!LoadBuffers(document, file_path, bin, file, buffers, error) ||
+      !CollectInstances(document, instances, error) ||
+      !CollectPrimitives(document, buffers, instances, primitives, error)) {
+    return invalid_format;
+  }
+  if (primitives.size() == 1 && IsMappable(primitives[0])) {
+    return MapPrimitive(primitives[0], mesh, error) ? success_code
+                                                    : invalid_format;
+  }
+  return GatherPrimitives(primitives, options, mesh, error);
+}
+}  // namespace
+
+bool HasGlbMagic(std::string_view head) { return head.starts_with("glTF"); }
+
+ErrorCode GltfLoader::Load(const std::string &file_path,
+                           const LoadOptions &options,
+                           WireframeObject &model) {
+  auto file = std::make_shared<const MappedFile>(file_path);
+  if (!file->IsMapped()) {
+    LogError("GltfLoader", file_not_found);
+    return file_not_found;
+  }
+  std::uint64_t file_size = file->GetView().size();
+  if (options.progress != nullptr) {
+    options.progress->SetTotalBytes(file_size);
+  }
+
+  GltfMesh mesh;
+  std::string error;
+  ErrorCode result_code = invalid_format;
+  try {
+    result_code = BuildMesh(file, file_path, options, mesh, error);
+  } catch (const Json::exception &exception) {
+    error = exception.what();
+  } catch (const std::bad_alloc &) {
+    result_code = memory_error;
+    error = GetStatusMessage(memory_error);
+  }
+  if (result_code != success_code) {
+    if (!error.empty()) LogError("GltfLoader", error);
+    return result_code;
+  }
+
+  model.vertices_ = std::move(mesh.vertices);
+  model.faces_ = std::move(mesh.faces);
+  model.count_.v = model.vertices_.size();
+  model.count_.f = model.faces_.size();
+  if (options.progress != nullptr) {
+    options.progress->Add(file_size, model.count_.Total());
+  }
+  return model.FinishParsing(success_code, options.thread_count);
+}
+}  // namespace s21
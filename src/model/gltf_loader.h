@@ -0,0 +1,46 @@
+#ifndef MODEL_GLTF_LOADER_H
+#define MODEL_GLTF_LOADER_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "model/errors.h"
+#include "model/parser.h"
+
+namespace s21 {
+// Binary glTF: a 12-byte header, then a JSON chunk and an optional BIN chunk
+const std::size_t kGlbHeaderBytes = 12;
+const std::size_t kGlbChunkHeaderBytes = 8;
+const std::uint32_t kGlbVersion = 2;
+const std::uint32_t kGlbChunkJson = 0x4e4f534a;
+const std::uint32_t kGlbChunkBin = 0x004e4942;
+
+// The file starts with "glTF"
+bool HasGlbMagic(std::string_view head);
+
+/**
+ * @class GltfLoader
+ * @brief Builds a WireframeObject from the triangle primitives of a glTF 2.0
+ * asset, .glb or .gltf
+ *
+ * Only the JSON part is parsed as text, with the bundled nlohmann::json;
+ * positions and indices are read from the binary buffers. A buffer can be the
+ * BIN chunk of a .glb, a file next to a .gltf (both mapped) or a base64 data
+ * URI.
+ *
+ * A model made of one triangle primitive that no node moves keeps its
+ * positions and 32-bit indices where they are: its arrays view the buffer
+ * and keep it alive, like meshes served from the MeshCache. Interleaved
+ * (strided) positions, 8 and 16-bit indices, several primitives and node
+ * transforms are gathered into owned arrays instead. Other attributes and
+ * primitive modes are skipped.
+ */
+class GltfLoader {
+ public:
+  static ErrorCode Load(const std::string &file_path,
+                        const LoadOptions &options, WireframeObject &model);
+};  // class GltfLoader
+}  // namespace s21
+
+#endif  // MODEL_GLTF_LOADER_H
@@ -0,0 +1,163 @@
+#include "model/gzip_reader.h"
+
+#include <zlib.h>
+
+#include <filesystem>
+
+namespace s21 {
+namespace {
+const unsigned char kGzipMagic[] = {0x1f, 0x8b};
+// The trailer ends with the decompressed size modulo 2^32
+const std::uint64_t kGzipTrailerBytes = 4;
+const std::uint64_t kGzipSizeModulus = std::uint64_t{1} << 32;
+}  // namespace
+
+GzipReader::GzipReader(const std::string &file_path)
+    : file_(file_path, std::ios::binary) {
+  if (!file_.is_open()) return;
+  is_open_ = true;
+  // Text doesn't compress below its gzip size, so a trailer smaller than the
+  // file has wrapped around at least once
+  std::error_code error;
+  std::uint64_t file_size = std::filesystem::file_size(file_path, error);
+  if (!error && file_size >= kGzipTrailerBytes) {
+    unsigned char trailer[kGzipTrailerBytes] = {};
+    file_.seekg(file_size - kGzipTrailerBytes);
+    file_.read(reinterpret_cast<char *>(trailer), kGzipTrailerBytes);
+    size_hint_ = trailer[0] | trailer[1] << 8 | trailer[2] << 16 |
+                 std::uint64_t{trailer[3]} << 24;
+    while (size_hint_ < file_size) size_hint_ += kGzipSizeModulus;
+  }
+  file_.clear();
+  file_.seekg(0);
+  thread_ = std::thread(&GzipReader::Run, this);
+}
+
+GzipReader::~GzipReader() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    is_stopped_ = true;
+  }
+  has_room_.notify_all();
+  if (thread_.joinable()) thread_.join();
+}
+
+bool GzipReader::HasMagic(std::string_view head) {
+  return head.size() >= sizeof(kGzipMagic) &&
+         static_cast<unsigned char>(head[0]) == kGzipMagic[0] &&
+         static_cast<unsigned char>(head[1]) == kGzipMagic[1];
+}
+
+bool GzipReader::Next(std::string &block) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (block.capacity() != 0) spare_blocks_.push_back(std::move(block));
+  block.clear();
+  has_block_.wait(lock, [this] { return !blocks_.empty() || is_finished_; });
+  if (blocks_.empty()) return false;
+  block = std::move(blocks_.front());
+  blocks_.pop_front();
+  lock.unlock();
+  has_room_.notify_one();
+  return true;
+}
+
+ErrorCode GzipReader::GetResult() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return result_code_;
+}
+
+void GzipReader::Run() {
+  ErrorCode result_code = InflateBlocks();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    result_code_ = result_code;
+    is_finished_ = true;
+  }
+  has_block_.notify_all();
+}
+
+ErrorCode GzipReader::InflateBlocks() {
+  z_stream stream{};
+  // 16: expect a gzip header and trailer
+  if (inflateInit2(&stream, MAX_WBITS + 16) != Z_OK) return memory_error;
+  std::vector<char> input(kGzipInputBytes);
+  std::string block, carry;
+  ErrorCode result_code = success_code;
+  bool is_end = false, is_member_end = false;
+
+  while (result_code == success_code && !is_end) {
+    block.assign(carry);
+    std::size_t target = block.size() + kGzipBlockBytes;
+    while (block.size() < target) {
+      if (stream.avail_in == 0) {
+        file_.read(input.data(), static_cast<std::streamsize>(input.size()));
+        stream.next_in = reinterpret_cast<Bytef *>(input.data());
+        stream.avail_in = static_cast<uInt>(file_.gcount());
+        if (stream.avail_in == 0) {
+          // The file ended inside a member
+          if (!is_member_end) result_code = invalid_format;
+          is_end = true;
+          break;
+        }
+      }
+      if (is_member_end) {
+        // Another member continues the text, anything else is trailing
+        // garbage that gzip ignores as well
+        if (stream.next_in[0] != kGzipMagic[0]) {
+          is_end = true;
+          break;
+        }
+        inflateReset(&stream);
+        is_member_end = false;
+      }
+      std::size_t size = block.size();
+      block.resize(target);
+      stream.next_out = reinterpret_cast<Bytef *>(block.data() + size);
+      stream.avail_out = static_cast<uInt>(target - size);
+      int status = inflate(&stream, Z_NO_FLUSH);
+      block.resize(target - stream.avail_out);
+      if (status == Z_STREAM_END) {
+        is_member_end = true;
+      } else if (status != Z_OK) {
+        result_code = status == Z_MEM_ERROR ? memory_error : invalid_format;
+        break;
+      }
+    }
+    if (result_code != success_code) break;
+
+    // The unfinished last line starts the next block; a block without any
+    // line break keeps growing until one shows up
+    carry.clear();
+    if (!is_end) {
+      std::size_t line_end = block.rfind('\n');
+      if (line_end == std::string::npos) {
+        carry.swap(block);
+        continue;
+      }
+      carry.assign(block, line_end + 1);
+      block.resize(line_end + 1);
+    }
+    if (!block.empty() && !Push(block)) break;
+  }
+  inflateEnd(&stream);
+  return result_code;
+}
+
+bool GzipReader::Push(std::string &block) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  has_room_.wait(lock, [this] {
+    return blocks_.size() < kGzipQueueBlocks || is_stopped_;
+  });
+  if (is_stopped_) return false;
+  blocks_.push_back(std::move(block));
+  block.clear();
+  if (!spare_blocks_.empty()) {
+    block = std::move(spare_blocks_.back());
+    spare_blocks_.pop_back();
+  }
+  lock.unlock();
+  has_block_.notify_one();
+  return true;
+}
+
+}  // namespace s21
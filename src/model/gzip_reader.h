@@ -0,0 +1,77 @@
+#ifndef MODEL_GZIP_READER_H
+#define MODEL_GZIP_READER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "model/errors.h"
+
+namespace s21 {
+// Decompressed text handed to the parser at a time
+const std::size_t kGzipBlockBytes = 1 << 20;
+// Blocks the inflating thread may run ahead of the parser
+const std::size_t kGzipQueueBlocks = 4;
+// Compressed bytes read from the file at a time
+const std::size_t kGzipInputBytes = 1 << 18;
+
+/**
+ * @class GzipReader
+ * @brief Inflates a gzip file on its own thread, block by block
+ *
+ * The decompressed text is cut into blocks of about kGzipBlockBytes that end
+ * on a line boundary, so every block can be parsed on its own. At most
+ * kGzipQueueBlocks blocks wait for the parser; consumed blocks are handed
+ * back through Next() and reused. Concatenated gzip members are read as one
+ * stream. Destroying the reader stops the thread, even in the middle of the
+ * file.
+ */
+class GzipReader {
+ public:
+  explicit GzipReader(const std::string &file_path);
+  ~GzipReader();
+  GzipReader(const GzipReader &) = delete;
+  GzipReader &operator=(const GzipReader &) = delete;
+
+  // The first bytes of a file are the gzip magic bytes
+  static bool HasMagic(std::string_view head);
+
+  bool IsOpen() const { return is_open_; }
+  // Decompressed size taken from the gzip trailer, 0 = unknown
+  std::uint64_t GetSizeHint() const { return size_hint_; }
+  // Replaces block with the next run of whole lines, false at the end of
+  // the input
+  bool Next(std::string &block);
+  // Once Next() returned false: success_code, or invalid_format for a
+  // corrupt or truncated file
+  ErrorCode GetResult();
+
+ private:
+  void Run();
+  ErrorCode InflateBlocks();
+  // Queues block and gives it a spare buffer, false once stopped
+  bool Push(std::string &block);
+
+  std::ifstream file_;
+  bool is_open_{false};
+  std::uint64_t size_hint_{0};
+  std::mutex mutex_;
+  std::condition_variable has_block_;
+  std::condition_variable has_room_;
+  std::deque<std::string> blocks_;
+  std::vector<std::string> spare_blocks_;
+  bool is_finished_{false};
+  bool is_stopped_{false};
+  ErrorCode result_code_{success_code};
+  // Last: the thread starts once everything else is set up
+  std::thread thread_;
+};  // class GzipReader
+}  // namespace s21
+
+#endif  // MODEL_GZIP_READER_H
@@ -0,0 +1,64 @@
+#ifndef MODEL_LOAD_PROGRESS_H
+#define MODEL_LOAD_PROGRESS_H
+
+#include <atomic>
+#include <cstdint>
+
+namespace s21 {
+// Lines parsed between two progress updates and cancellation checks
+const std::uint64_t kProgressLines = 1 << 16;
+
+/**
+ * @class LoadProgress
+ * @brief Progress counters and a cancellation flag shared between the
+ * threads loading a model and the one watching them
+ *
+ * Parsing threads add what they have processed every kProgressLines lines
+ * and stop with load_cancelled once Cancel() was called. Observers poll the
+ * counters; all accesses are lock-free.
+ */
+class LoadProgress {
+ public:
+  void Reset(std::uint64_t total_bytes) {
+    total_bytes_.store(total_bytes, std::memory_order_relaxed);
+    bytes_processed_.store(0, std::memory_order_relaxed);
+    records_parsed_.store(0, std::memory_order_relaxed);
+    is_cancelled_.store(false, std::memory_order_relaxed);
+  }
+  // Called by the loader once the input size is known
+  void SetTotalBytes(std::uint64_t total_bytes) {
+    total_bytes_.store(total_bytes, std::memory_order_relaxed);
+  }
+  // Starts counting over for a second pass, keeping a pending cancellation
+  void Rewind() {
+    bytes_processed_.store(0, std::memory_order_relaxed);
+    records_parsed_.store(0, std::memory_order_relaxed);
+  }
+  void Add(std::uint64_t bytes, std::uint64_t records) {
+    bytes_processed_.fetch_add(bytes, std::memory_order_relaxed);
+    records_parsed_.fetch_add(records, std::memory_order_relaxed);
+  }
+  void Cancel() { is_cancelled_.store(true, std::memory_order_relaxed); }
+
+  bool IsCancelled() const {
+    return is_cancelled_.load(std::memory_order_relaxed);
+  }
+  std::uint64_t GetTotalBytes() const {
+    return total_bytes_.load(std::memory_order_relaxed);
+  }
+  std::uint64_t GetBytesProcessed() const {
+    return bytes_processed_.load(std::memory_order_relaxed);
+  }
+  std::uint64_t GetRecordsParsed() const {
+    return records_parsed_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  std::atomic<std::uint64_t> total_bytes_{0};
+  std::atomic<std::uint64_t> bytes_processed_{0};
+  std::atomic<std::uint64_t> records_parsed_{0};
+  std::atomic<bool> is_cancelled_{false};
+};  // class LoadProgress
+}  // namespace s21
+
+#endif  // MODEL_LOAD_PROGRESS_H
@@ -0,0 +1,46 @@
+#include "model/mapped_file.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace s21 {
+
+MappedFile::MappedFile(const std::string &file_path, bool is_sequential) {
+  // Check the type before opening: opening a FIFO blocks until a writer
+  // shows up, and closing it again breaks the pipe for the stream fallback
+  struct stat file_stat;
+  if (stat(file_path.c_str(), &file_stat) != 0 ||
+      !S_ISREG(file_stat.st_mode)) {
+    return;
+  }
+  int fd = open(file_path.c_str(), O_RDONLY);
+  if (fd < 0) return;
+
+  if (fstat(fd, &file_stat) == 0 && S_ISREG(file_stat.st_mode)) {
+    size_ = static_cast<std::size_t>(file_stat.st_size);
+    if (size_ == 0) {
+      // mmap refuses zero-length mappings, an empty view is enough
+      is_mapped_ = true;
+    } else {
+      void *data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (data != MAP_FAILED) {
+        // The parser reads a sequential mapping front to back exactly once
+        if (is_sequential) madvise(data, size_, MADV_SEQUENTIAL);
+        data_ = data;
+        is_mapped_ = true;
+      } else {
+        size_ = 0;
+      }
+    }
+  }
+  // The mapping stays valid after the descriptor is closed
+  close(fd);
+}
+
+MappedFile::~MappedFile() {
+  if (data_ != nullptr) munmap(data_, size_);
+}
+
+}  // namespace s21
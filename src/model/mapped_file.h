@@ -0,0 +1,40 @@
+#ifndef MODEL_MAPPED_FILE_H
+#define MODEL_MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace s21 {
+
+/**
+ * @class MappedFile
+ * @brief Read-only memory mapping of a regular file
+ *
+ * The whole file is mapped into the address space so the parser can tokenize
+ * the bytes in place without copying them into lines. Pipes, sockets and other
+ * non-regular files can't be mapped: IsMapped() returns false for them and the
+ * caller is expected to fall back to stream reading. Mappings read front to
+ * back once (parsing) are advised as sequential, ones kept for random access
+ * (cache entries backing a mesh) are not.
+ */
+class MappedFile {
+ public:
+  explicit MappedFile(const std::string &file_path, bool is_sequential = true);
+  ~MappedFile();
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  bool IsMapped() const { return is_mapped_; }
+  std::string_view GetView() const {
+    return std::string_view(static_cast<const char *>(data_), size_);
+  }
+
+ private:
+  void *data_{nullptr};
+  std::size_t size_{0};
+  bool is_mapped_{false};
+};  // class MappedFile
+}  // namespace s21
+
+#endif  // MODEL_MAPPED_FILE_H
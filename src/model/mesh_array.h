@@ -0,0 +1,95 @@
+#ifndef MODEL_MESH_ARRAY_H
+#define MODEL_MESH_ARRAY_H
+
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "model/arena.h"
+
+namespace s21 {
+
+/**
+ * @class MeshArray
+ * @brief Read-only array of mesh records that either owns its elements or
+ * views memory kept alive by someone else
+ *
+ * Parsed meshes own their data in a std::vector. Meshes served from the
+ * binary cache point straight into the mapped cache file; the mapping is held
+ * by a shared backing object, so copies of such an array are cheap and never
+ * outlive the memory they view. Owned elements may sit in a load's Arena;
+ * copies of such an array are made on the heap.
+ */
+template <typename T>
+class MeshArray {
+ public:
+  MeshArray() = default;
+  MeshArray(ArenaVector<T> &&values) : owned_(std::move(values)) {}
+  MeshArray(const T *data, std::size_t size,
+            std::shared_ptr<const void> backing)
+      : view_(data, size), backing_(std::move(backing)) {}
+
+  MeshArray(const MeshArray &other)
+      : owned_(other.owned_), view_(other.view_), backing_(other.backing_) {}
+  MeshArray &operator=(const MeshArray &other) {
+    if (this != &other) {
+      // Built aside so the copy lands on the heap, not in our arena
+      owned_ = ArenaVector<T>(other.owned_, ArenaAllocator<T>());
+      view_ = other.view_;
+      backing_ = other.backing_;
+    }
+    return *this;
+  }
+  MeshArray(MeshArray &&other) noexcept
+      : owned_(std::move(other.owned_)),
+        view_(other.view_),
+        backing_(std::move(other.backing_)) {
+    other.clear();
+  }
+  MeshArray &operator=(MeshArray &&other) noexcept {
+    if (this != &other) {
+      owned_ = std::move(other.owned_);
+      view_ = other.view_;
+      backing_ = std::move(other.backing_);
+      other.clear();
+    }
+    return *this;
+  }
+  MeshArray &operator=(ArenaVector<T> &&values) noexcept {
+    owned_ = std::move(values);
+    view_ = std::span<const T>();
+    backing_.reset();
+    return *this;
+  }
+
+  bool IsMapped() const { return backing_ != nullptr; }
+  const T *data() const { return IsMapped() ? view_.data() : owned_.data(); }
+  std::size_t size() const {
+    return IsMapped() ? view_.size() : owned_.size();
+  }
+  std::size_t size_bytes() const { return size() * sizeof(T); }
+  bool empty() const { return size() == 0; }
+  const T *begin() const { return data(); }
+  const T *end() const { return data() + size(); }
+  const T &operator[](std::size_t index) const { return data()[index]; }
+  operator std::span<const T>() const {
+    return std::span<const T>(data(), size());
+  }
+
+  // Frees the elements, an arena they were in is no longer needed
+  void clear() noexcept {
+    owned_ = ArenaVector<T>();
+    view_ = std::span<const T>();
+    backing_.reset();
+  }
+
+ private:
+  ArenaVector<T> owned_;
+  std::span<const T> view_;
+  std::shared_ptr<const void> backing_;
+};  // class MeshArray
+}  // namespace s21
+
+#endif  // MODEL_MESH_ARRAY_H
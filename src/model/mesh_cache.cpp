@@ -0,0 +1,272 @@
+#include "model/mesh_cache.h"
+
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace s21 {
+namespace {
+// Blocks hashed independently, then combined in order
+const std::size_t kHashBlockBytes = 4 << 20;
+const std::uint64_t kHashMultiplier = 0x9E3779B97F4A7C15ULL;
+
+std::uint64_t Mix(std::uint64_t value) {
+  value ^= value >> 31;
+  value *= 0xBF58476D1CE4E5B9ULL;
+  value ^= value >> 29;
+  return value;
+}
+
+std::uint64_t HashBlock(std::string_view block) {
+  // Four independent lanes keep the multiplier pipeline busy
+  std::uint64_t lanes[4] = {1, 2, 3, 4};
+  std::size_t position = 0;
+  for (; position + 32 <= block.size(); position += 32) {
+    for (int lane = 0; lane < 4; ++lane) {
+      std::uint64_t word;
+      std::memcpy(&word, block.data() + position + lane * 8, sizeof(word));
+      lanes[lane] = (lanes[lane] ^ word) * kHashMultiplier;
+    }
+  }
+  std::uint64_t hash = block.size();
+  for (std::uint64_t lane : lanes) hash = Mix(hash ^ lane) * kHashMultiplier;
+  for (; position < block.size(); ++position) {
+    hash = (hash ^ static_cast<unsigned char>(block[position])) *
+           kHashMultiplier;
+  }
+  return Mix(hash);
+}
+
+std::size_t AlignUp(std::size_t offset) {
+  return (offset + kMeshCacheAlignment - 1) / kMeshCacheAlignment *
+         kMeshCacheAlignment;
+}
+
+template <typename T>
+bool SectionFits(const MeshCacheSection &section, std::size_t file_size) {
+  return section.offset % alignof(T) == 0 && section.offset <= file_size &&
+         section.count <= (file_size - section.offset) / sizeof(T);
+}
+
+template <typename T>
+MeshArray<T> SectionArray(const MeshCacheSection &section,
+                          const std::shared_ptr<const MappedFile> &file) {
+  if (section.count == 0) return MeshArray<T>();
+  const char *data = file->GetView().data() + section.offset;
+  return MeshArray<T>(reinterpret_cast<const T *>(data), section.count, file);
+}
+
+// Every index must name an existing record, kNoIndex is allowed only for
+// optional attributes
+template <typename T>
+bool IndicesFit(const MeshArray<T> &records, std::size_t limit,
+                bool allow_missing) {
+  for (const T &record : records) {
+    for (std::uint32_t index : record.index) {
+      if (index >= limit && !(allow_missing && index == kNoIndex)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+template <typename T>
+void WriteSection(std::ofstream &file, const MeshArray<T> &records,
+                  MeshCacheSection &section) {
+  std::size_t offset = AlignUp(static_cast<std::size_t>(file.tellp()));
+  static const char padding[kMeshCacheAlignment] = {};
+  file.write(padding, offset - static_cast<std::size_t>(file.tellp()));
+  section.offset = offset;
+  section.count = records.size();
+  file.write(reinterpret_cast<const char *>(records.data()),
+             records.size_bytes());
+}
+}  // namespace
+
+std::uint64_t HashContent(std::string_view buffer, unsigned thread_count) {
+  std::size_t block_count =
+      (buffer.size() + kHashBlockBytes - 1) / kHashBlockBytes;
+  std::vector<std::uint64_t> block_hashes(block_count);
+  ParallelFor(block_count, ResolveThreadCount(thread_count),
+              [&](std::size_t i) {
+                block_hashes[i] =
+                    HashBlock(buffer.substr(i * kHashBlockBytes,
+                                            kHashBlockBytes));
+              });
+  std::uint64_t hash = Mix(buffer.size() + kHashMultiplier);
+  for (std::uint64_t block_hash : block_hashes) {
+    hash = Mix(hash ^ block_hash) * kHashMultiplier;
+  }
+  return Mix(hash);
+}
+
+MeshCache::MeshCache(const std::string &directory)
+    : directory_(directory.empty() ? DefaultDirectory() : directory) {}
+
+std::string MeshCache::DefaultDirectory() {
+  std::filesystem::path base;
+  if (const char *xdg_cache = std::getenv("XDG_CACHE_HOME");
+      xdg_cache != nullptr && *xdg_cache != '\0') {
+    base = xdg_cache;
+  } else if (const char *home = std::getenv("HOME");
+             home != nullptr && *home != '\0') {
+    base = std::filesystem::path(home) / ".cache";
+  } else {
+    std::error_code error;
+    base = std::filesystem::temp_directory_path(error);
+  }
+  return (base / "3DViewer").string();
+}
+
+std::optional<MeshCacheKey> MeshCache::MakeKey(const std::string &source_path,
+                                               unsigned thread_count) {
+  std::error_code error;
+  MeshCacheKey key;
+  key.path = std::filesystem::weakly_canonical(source_path, error).string();
+  if (error) return std::nullopt;
+  auto mtime = std::filesystem::last_write_time(source_path, error);
+  if (error) return std::nullopt;
+  key.mtime = static_cast<std::int64_t>(mtime.time_since_epoch().count());
+
+  MappedFile source(source_path);
+  if (!source.IsMapped()) return std::nullopt;
+  key.size = source.GetView().size();
+  key.hash = HashContent(source.GetView(), thread_count);
+  return key;
+}
+
+std::string MeshCache::EntryPath(const MeshCacheKey &key) const {
+  char name[17];
+  std::snprintf(name, sizeof(name), "%016llx",
+                static_cast<unsigned long long>(HashBlock(key.path)));
+  return (std::filesystem::path(directory_) /
+          (std::string(name) + kMeshCacheExtension))
+      .string();
+}
+
+std::optional<WireframeObject> MeshCache::Fetch(const MeshCacheKey &key) const {
+  auto file = std::make_shared<const MappedFile>(EntryPath(key), false);
+  std::string_view entry = file->GetView();
+  MeshCacheHeader header;
+  if (!file->IsMapped() || entry.size() < sizeof(header)) return std::nullopt;
+  std::memcpy(&header, entry.data(), sizeof(header));
+
+  if (std::memcmp(header.magic, kMeshCacheMagic, sizeof(header.magic)) != 0 ||
+      header.version != kMeshCacheVersion ||
+      header.byte_order != kMeshCacheByteOrder ||
+      header.source_size != key.size || header.source_mtime != key.mtime ||
+      header.source_hash != key.hash ||
+      header.triangulation != static_cast<std::uint64_t>(key.triangulation) ||
+      header.path_offset > entry.size() ||
+      header.path_length != key.path.size() ||
+      entry.substr(header.path_offset, header.path_length) != key.path) {
+    return std::nullopt;
+  }
+
+  const MeshCacheSection *sections = header.sections;
+  if (!SectionFits<Coordinate>(sections[kSectionVertices], entry.size()) ||
+      !SectionFits<TextureCoordinate>(sections[kSectionTextures],
+                                      entry.size()) ||
+      !SectionFits<Coordinate>(sections[kSectionNormals], entry.size()) ||
+      !SectionFits<Face>(sections[kSectionFaces], entry.size()) ||
+      !SectionFits<Face>(sections[kSectionTextureFaces], entry.size()) ||
+      !SectionFits<Face>(sections[kSectionNormalFaces], entry.size()) ||
+      !SectionFits<Edge>(sections[kSectionEdges], entry.size()) ||
+      !SectionFits<FaceEdgeMask>(sections[kSectionFaceEdges], entry.size())) {
+    return std::nullopt;
+  }
+
+  WireframeObject model;
+  model.vertices_ = SectionArray<Coordinate>(sections[kSectionVertices], file);
+  model.textures_ =
+      SectionArray<TextureCoordinate>(sections[kSectionTextures], file);
+  model.normals_ = SectionArray<Coordinate>(sections[kSectionNormals], file);
+  model.faces_ = SectionArray<Face>(sections[kSectionFaces], file);
+  model.texture_faces_ =
+      SectionArray<Face>(sections[kSectionTextureFaces], file);
+  model.normal_faces_ = SectionArray<Face>(sections[kSectionNormalFaces], file);
+  model.edges_ = SectionArray<Edge>(sections[kSectionEdges], file);
+  model.face_edges_ =
+      SectionArray<FaceEdgeMask>(sections[kSectionFaceEdges], file);
+  model.bounds_ = header.bounds;
+  model.count_.v = model.vertices_.size();
+  model.count_.vt = model.textures_.size();
+  model.count_.vn = model.normals_.size();
+  model.count_.f = model.faces_.size();
+
+  // A damaged entry must not hand out-of-range indices to the renderer
+  std::size_t face_count = model.faces_.size();
+  if (!model.ValidateCounters() ||
+      (!model.texture_faces_.empty() &&
+       model.texture_faces_.size() != face_count) ||
+      (!model.normal_faces_.empty() &&
+       model.normal_faces_.size() != face_count) ||
+      (!model.face_edges_.empty() && model.face_edges_.size() != face_count) ||
+      !IndicesFit(model.faces_, model.vertices_.size(), false) ||
+      !IndicesFit(model.texture_faces_, model.textures_.size(), true) ||
+      !IndicesFit(model.normal_faces_, model.normals_.size(), true) ||
+      !IndicesFit(model.edges_, model.vertices_.size(), false)) {
+    return std::nullopt;
+  }
+
+  model.id_ = WireframeObject::next_id_++;
+  model.AssignName(key.path);
+  return model;
+}
+
+bool MeshCache::Store(const MeshCacheKey &key,
+                      const WireframeObject &model) const {
+  // Entries hold 32-bit indices only; meshes past that range are re-parsed
+  if (model.GetIndexWidth() != kIndex32) return false;
+  std::error_code error;
+  std::filesystem::create_directories(directory_, error);
+  std::string entry_path = EntryPath(key);
+  // Readers never see a half-written entry: write aside, then rename
+  std::string temp_path = entry_path + "." + std::to_string(getpid());
+
+  MeshCacheHeader header = {};
+  std::memcpy(header.magic, kMeshCacheMagic, sizeof(header.magic));
+  header.version = kMeshCacheVersion;
+  header.byte_order = kMeshCacheByteOrder;
+  header.source_size = key.size;
+  header.source_mtime = key.mtime;
+  header.source_hash = key.hash;
+  header.path_offset = sizeof(header);
+  header.path_length = key.path.size();
+  header.triangulation = key.triangulation;
+  header.bounds = model.bounds_;
+
+  std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+  // The header is rewritten with the section offsets once they are known
+  file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  file.write(key.path.data(), key.path.size());
+  MeshCacheSection *sections = header.sections;
+  WriteSection(file, model.vertices_, sections[kSectionVertices]);
+  WriteSection(file, model.textures_, sections[kSectionTextures]);
+  WriteSection(file, model.normals_, sections[kSectionNormals]);
+  WriteSection(file, model.faces_, sections[kSectionFaces]);
+  WriteSection(file, model.texture_faces_, sections[kSectionTextureFaces]);
+  WriteSection(file, model.normal_faces_, sections[kSectionNormalFaces]);
+  WriteSection(file, model.edges_, sections[kSectionEdges]);
+  WriteSection(file, model.face_edges_, sections[kSectionFaceEdges]);
+  file.seekp(0);
+  file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  file.close();
+
+  if (!file) {
+    LogError("MeshCache", "Cannot write cache entry " + temp_path);
+    std::filesystem::remove(temp_path, error);
+    return false;
+  }
+  std::filesystem::rename(temp_path, entry_path, error);
+  if (error) {
+    LogError("MeshCache", "Cannot write cache entry " + entry_path);
+    std::filesystem::remove(temp_path, error);
+    return false;
+  }
+  return true;
+}
+}  // namespace s21
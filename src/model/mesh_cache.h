@@ -0,0 +1,101 @@
+#ifndef MODEL_MESH_CACHE_H
+#define MODEL_MESH_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "model/mesh_types.h"
+#include "model/parser.h"
+
+namespace s21 {
+// Bump whenever the layout of MeshCacheHeader or of a section changes, or a
+// section that used to be left empty gets filled
+const std::uint32_t kMeshCacheVersion = 3;
+const char kMeshCacheMagic[8] = {'S', '2', '1', 'M', 'E', 'S', 'H', '\0'};
+// Written as a number, read back differently on a machine of other endianness
+const std::uint32_t kMeshCacheByteOrder = 0x01020304;
+// Sections start on cache line boundaries so mapped arrays are aligned
+const std::size_t kMeshCacheAlignment = 64;
+const char kMeshCacheExtension[] = ".s21mesh";
+
+typedef enum {
+  kSectionVertices = 0,
+  kSectionTextures,
+  kSectionNormals,
+  kSectionFaces,
+  kSectionTextureFaces,
+  kSectionNormalFaces,
+  kSectionEdges,
+  kSectionFaceEdges,
+  kSectionCount,
+} MeshCacheSectionT;
+
+struct MeshCacheSection {
+  std::uint64_t offset = 0;  // from the start of the file
+  std::uint64_t count = 0;   // records, not bytes
+};
+
+// Identifies the exact source file contents an entry was built from
+struct MeshCacheKey {
+  std::string path;  // canonical
+  std::uint64_t size = 0;
+  std::int64_t mtime = 0;
+  std::uint64_t hash = 0;
+  // Fan and ear clipping cut the same polygons differently
+  TriangulationT triangulation = kTriangulateFan;
+};
+
+struct MeshCacheHeader {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t byte_order;
+  std::uint64_t source_size;
+  std::int64_t source_mtime;
+  std::uint64_t source_hash;
+  std::uint64_t path_offset;
+  std::uint64_t path_length;
+  std::uint64_t triangulation;
+  Bounds bounds;
+  MeshCacheSection sections[kSectionCount];
+};
+static_assert(std::is_trivially_copyable_v<MeshCacheHeader>);
+
+// 64-bit hash of a buffer, split into blocks hashed on thread_count threads
+std::uint64_t HashContent(std::string_view buffer, unsigned thread_count = 0);
+
+/**
+ * @class MeshCache
+ * @brief Binary cache of parsed meshes, one entry file per source path
+ *
+ * An entry holds a fixed header followed by the source path and the mesh
+ * arrays exactly as WireframeObject stores them in memory. Fetch() maps the
+ * entry and lets the returned mesh view the arrays in place, so a warm open
+ * costs a hash of the source file plus an index range check instead of a
+ * parse. An entry is used only when path, size, modification time and
+ * content hash of the source all match; stale or damaged entries are
+ * ignored and overwritten by the next Store().
+ */
+class MeshCache {
+ public:
+  explicit MeshCache(const std::string &directory = std::string());
+
+  // $XDG_CACHE_HOME/3DViewer, ~/.cache/3DViewer or a temp directory
+  static std::string DefaultDirectory();
+  static std::optional<MeshCacheKey> MakeKey(const std::string &source_path,
+                                             unsigned thread_count = 0);
+
+  std::string GetDirectory() const { return directory_; }
+  std::string EntryPath(const MeshCacheKey &key) const;
+  std::optional<WireframeObject> Fetch(const MeshCacheKey &key) const;
+  bool Store(const MeshCacheKey &key, const WireframeObject &model) const;
+
+ private:
+  std::string directory_;
+};  // class MeshCache
+}  // namespace s21
+
+#endif  // MODEL_MESH_CACHE_H
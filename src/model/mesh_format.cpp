@@ -0,0 +1,83 @@
+#include "model/mesh_format.h"
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+
+#include "model/gltf_loader.h"
+#include "model/gzip_reader.h"
+#include "model/ply_loader.h"
+#include "model/stl_loader.h"
+
+namespace s21 {
+namespace {
+bool MatchesGzip(std::string_view head, std::uintmax_t /*file_size*/) {
+  return GzipReader::HasMagic(head);
+}
+
+bool MatchesGlb(std::string_view head, std::uintmax_t /*file_size*/) {
+  return HasGlbMagic(head);
+}
+
+bool MatchesPly(std::string_view head, std::uintmax_t /*file_size*/) {
+  return HasPlyMagic(head);
+}
+
+const MeshFormat kMeshFormats[] = {
+    {kFormatObj, "Wavefront OBJ", "*.obj", nullptr, nullptr},
+    {kFormatObjGzip, "Compressed OBJ", "*.obj.gz", &MatchesGzip, nullptr},
+    {kFormatStl, "Binary STL", "*.stl", &IsBinaryStl, &ParseBinaryStl},
+    {kFormatPly, "Binary PLY", "*.ply", &MatchesPly, &ParseBinaryPly},
+    {kFormatGltf, "glTF", "*.glb *.gltf", &MatchesGlb, nullptr},
+};
+
+bool HasExtension(const std::string &file_path, std::string_view patterns) {
+  std::string path = file_path;
+  std::transform(path.begin(), path.end(), path.begin(),
+                 [](unsigned char c) { return std::tolower(c); });
+  std::size_t start = 0;
+  while (start < patterns.size()) {
+    std::size_t end = std::min(patterns.find(' ', start), patterns.size());
+    // "*.stl" -> ".stl"
+    std::string_view extension = patterns.substr(start + 1, end - start - 1);
+    if (path.ends_with(extension)) return true;
+    start = end + 1;
+  }
+  return false;
+}
+}  // namespace
+
+std::span<const MeshFormat> GetMeshFormats() { return kMeshFormats; }
+
+const MeshFormat &DetectMeshFormat(const std::string &file_path) {
+  // Reading from a FIFO would take its first bytes from the stream fallback
+  std::error_code error;
+  if (std::filesystem::is_regular_file(file_path, error)) {
+    std::uintmax_t file_size = std::filesystem::file_size(file_path, error);
+    std::ifstream file(file_path, std::ios::binary);
+    std::string head(kMeshFormatHeadBytes, '\0');
+    file.read(head.data(), static_cast<std::streamsize>(head.size()));
+    head.resize(static_cast<std::size_t>(file.gcount()));
+    for (const MeshFormat &format : kMeshFormats) {
+      if (!error && format.matches != nullptr &&
+          format.matches(head, file_size)) {
+        return format;
+      }
+    }
+  }
+  for (const MeshFormat &format : kMeshFormats) {
+    if (HasExtension(file_path, format.patterns)) return format;
+  }
+  return kMeshFormats[kFormatObj];
+}
+
+std::string MeshFormatFilter() {
+  std::string all, each;
+  for (const MeshFormat &format : kMeshFormats) {
+    all += (all.empty() ? "" : " ") + std::string(format.patterns);
+    each += ";;" + std::string(format.name) + " (" + format.patterns + ")";
+  }
+  return "All models (" + all + ")" + each;
+}
+}  // namespace s21
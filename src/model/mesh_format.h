@@ -0,0 +1,55 @@
+#ifndef MODEL_MESH_FORMAT_H
+#define MODEL_MESH_FORMAT_H
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "model/errors.h"
+#include "model/obj_chunk.h"
+
+namespace s21 {
+// Bytes of a file DetectMeshFormat() looks at
+const std::size_t kMeshFormatHeadBytes = 128;
+
+typedef enum {
+  kFormatObj = 0,  // Wavefront OBJ text
+  kFormatObjGzip,  // the same, gzip-compressed
+  kFormatStl,      // binary STL
+  kFormatPly,      // binary little-endian PLY
+  kFormatGltf,     // glTF 2.0, .glb or .gltf
+} MeshFormatT;
+
+// Reads a whole mapped file into chunk, which arrives with its arena,
+// progress, memory budget and triangulation set
+using MeshLoader = ErrorCode (*)(std::string_view data, ObjChunk &chunk,
+                                 unsigned thread_count);
+
+struct MeshFormat {
+  MeshFormatT format;
+  const char *name;
+  // File name patterns for file dialogs, separated by spaces
+  const char *patterns;
+  // Recognises the format from the first bytes and the size of a file,
+  // nullptr = by extension only
+  bool (*matches)(std::string_view head, std::uintmax_t file_size);
+  // nullptr for the OBJ formats WireframeObject parses itself and for glTF,
+  // which GltfLoader builds without a chunk
+  MeshLoader load;
+};
+
+/**
+ * @brief Formats WireframeObject can load, OBJ first
+ *
+ * DetectMeshFormat() tries the magic bytes of every format before the
+ * extensions, so a misnamed file still loads. Files nothing matches are read
+ * as OBJ, as are pipes and other files that can't be peeked at.
+ */
+std::span<const MeshFormat> GetMeshFormats();
+const MeshFormat &DetectMeshFormat(const std::string &file_path);
+// "All models (...);;OBJ (...);;..." for QFileDialog
+std::string MeshFormatFilter();
+}  // namespace s21
+
+#endif  // MODEL_MESH_FORMAT_H
@@ -0,0 +1,195 @@
+#include "model/mesh_lod.h"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cmath>
+
+#include "model/edge_list.h"
+#include "model/parallel.h"
+
+namespace s21 {
+namespace {
+const std::uint32_t kNoCluster = UINT32_MAX;
+
+struct ClusterSum {
+  double x = 0.0, y = 0.0, z = 0.0;
+  std::uint32_t count = 0;
+};
+
+std::uint64_t HashCell(std::uint64_t cell) {
+  cell ^= cell >> 33;
+  cell *= 0xff51afd7ed558ccdULL;
+  return cell ^ cell >> 33;
+}
+
+// Open addressing from cell to cluster, the cell of a cluster is kept next
+// to its sum; grows with the clusters rather than with the vertices
+class ClusterTable {
+ public:
+  explicit ClusterTable(std::size_t expected)
+      : slots_(std::bit_ceil(std::max<std::size_t>(expected * 2, 1024)),
+               kNoCluster) {}
+
+  std::uint32_t Find(std::uint64_t cell) {
+    std::size_t mask = slots_.size() - 1;
+    std::size_t slot = HashCell(cell) & mask;
+    while (slots_[slot] != kNoCluster) {
+      if (cells_[slots_[slot]] == cell) return slots_[slot];
+      slot = (slot + 1) & mask;
+    }
+    std::uint32_t cluster = static_cast<std::uint32_t>(cells_.size());
+    slots_[slot] = cluster;
+    cells_.push_back(cell);
+    sums_.emplace_back();
+    if (cells_.size() * 2 > slots_.size()) Grow();
+    return cluster;
+  }
+
+  std::vector<ClusterSum> &GetSums() { return sums_; }
+
+ private:
+  void Grow() {
+    std::vector<std::uint32_t> slots(slots_.size() * 2, kNoCluster);
+    std::size_t mask = slots.size() - 1;
+    for (std::uint32_t cluster = 0; cluster < cells_.size(); ++cluster) {
+      std::size_t slot = HashCell(cells_[cluster]) & mask;
+      while (slots[slot] != kNoCluster) slot = (slot + 1) & mask;
+      slots[slot] = cluster;
+    }
+    slots_ = std::move(slots);
+  }
+
+  std::vector<std::uint32_t> slots_;
+  std::vector<std::uint64_t> cells_;
+  std::vector<ClusterSum> sums_;
+};
+}  // namespace
+
+MeshLod ClusterVertices(std::span<const Coordinate> vertices,
+                        std::span<const Face> faces,
+                        std::span<const FaceEdgeMask> face_edges,
+                        const Bounds &bounds, unsigned grid_cells,
+                        unsigned thread_count,
+                        const std::atomic<bool> *cancel) {
+  auto start = std::chrono::steady_clock::now();
+  MeshLod lod;
+  lod.grid_cells = grid_cells;
+  if (vertices.empty() || bounds.IsEmpty() || grid_cells == 0) return lod;
+
+  float extent[3] = {bounds.max.x - bounds.min.x, bounds.max.y - bounds.min.y,
+                     bounds.max.z - bounds.min.z};
+  float longest = std::max({extent[0], extent[1], extent[2]});
+  // A box flat on every axis is one cell
+  float inverse_cell = longest > 0.0f ? grid_cells / longest : 0.0f;
+  float last_cell[3];
+  std::uint64_t cells_per_axis[3];
+  for (int axis = 0; axis < 3; ++axis) {
+    cells_per_axis[axis] = std::min<std::uint64_t>(
+        grid_cells,
+        static_cast<std::uint64_t>(extent[axis] * inverse_cell) + 1);
+    last_cell[axis] = static_cast<float>(cells_per_axis[axis] - 1);
+  }
+  // NaN positions end up in the first cell
+  auto axis_cell = [&](float value, float origin, int axis) {
+    float cell = std::max(0.0f, (value - origin) * inverse_cell);
+    return static_cast<std::uint64_t>(std::min(cell, last_cell[axis]));
+  };
+  auto is_cancelled = [cancel] {
+    return cancel != nullptr && cancel->load(std::memory_order_relaxed);
+  };
+
+  std::vector<std::uint64_t> cells(vertices.size());
+  std::size_t block_count =
+      (vertices.size() + kLodBlockVertices - 1) / kLodBlockVertices;
+  ParallelFor(block_count, thread_count, [&](std::size_t block) {
+    if (is_cancelled()) return;
+    std::size_t end =
+        std::min(vertices.size(), (block + 1) * kLodBlockVertices);
+    for (std::size_t i = block * kLodBlockVertices; i < end; ++i) {
+      const Coordinate &vertex = vertices[i];
+      cells[i] = (axis_cell(vertex.x, bounds.min.x, 0) * cells_per_axis[1] +
+                  axis_cell(vertex.y, bounds.min.y, 1)) *
+                     cells_per_axis[2] +
+                 axis_cell(vertex.z, bounds.min.z, 2);
+    }
+  });
+
+  // Serial, so clusters are numbered the same whatever the thread count
+  ClusterTable table(faces.size() / 8);
+  std::vector<std::uint32_t> remap(vertices.size());
+  for (std::size_t i = 0; i < vertices.size(); ++i) {
+    if (i % kLodBlockVertices == 0 && is_cancelled()) return MeshLod();
+    remap[i] = table.Find(cells[i]);
+    ClusterSum &sum = table.GetSums()[remap[i]];
+    sum.x += vertices[i].x;
+    sum.y += vertices[i].y;
+    sum.z += vertices[i].z;
+    ++sum.count;
+  }
+  lod.vertices.reserve(table.GetSums().size());
+  for (const ClusterSum &sum : table.GetSums()) {
+    lod.vertices.push_back({static_cast<float>(sum.x / sum.count),
+                            static_cast<float>(sum.y / sum.count),
+                            static_cast<float>(sum.z / sum.count)});
+  }
+
+  bool has_masks = face_edges.size() == faces.size();
+  for (std::size_t i = 0; i < faces.size(); ++i) {
+    if (i % kLodBlockVertices == 0 && is_cancelled()) return MeshLod();
+    Face face;
+    for (int k = 0; k < 3; ++k) {
+      // Corners out of range are caught by the parser, not repeated here
+      face.index[k] = faces[i].index[k] < remap.size()
+                          ? remap[faces[i].index[k]]
+                          : kNoCluster;
+    }
+    if (face.index[0] == face.index[1] || face.index[1] == face.index[2] ||
+        face.index[0] == face.index[2] || face.index[0] == kNoCluster ||
+        face.index[1] == kNoCluster || face.index[2] == kNoCluster) {
+      continue;
+    }
+    lod.faces.push_back(face);
+    if (has_masks) lod.face_edges.push_back(face_edges[i]);
+  }
+  if (is_cancelled()) return MeshLod();
+  BuildEdgeList(lod.faces, lod.face_edges, lod.vertices.size(), thread_count,
+                lod.edges);
+
+  lod.milliseconds = std::chrono::duration<double, std::milli>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+  return lod;
+}
+
+std::vector<MeshLod> BuildLodChain(const WireframeObject &model,
+                                   unsigned thread_count,
+                                   const std::atomic<bool> *cancel) {
+  std::vector<MeshLod> chain;
+  std::span<const Coordinate> vertices = model.GetVertices();
+  std::span<const Face> faces = model.GetFaces();
+  std::span<const FaceEdgeMask> face_edges = model.GetFaceEdges();
+  if (model.GetIndexWidth() != kIndex32 || faces.size() < kLodMinFaces) {
+    return chain;
+  }
+
+  // A surface crosses about 3 g^2 of the g^3 cells and gets two triangles
+  // per cell it crosses: start near a quarter of the faces
+  unsigned grid_cells = std::bit_ceil(static_cast<unsigned>(
+      std::sqrt(static_cast<double>(faces.size()) / 24.0)));
+  for (; grid_cells >= kLodMinGridCells; grid_cells /= 2) {
+    MeshLod lod =
+        ClusterVertices(vertices, faces, face_edges, model.GetBounds(),
+                        grid_cells, thread_count, cancel);
+    if (cancel != nullptr && cancel->load()) break;
+    if (lod.faces.size() > faces.size() * kLodMaxFaceShare) continue;
+    chain.push_back(std::move(lod));
+    // Moving a level keeps its arrays where they are
+    vertices = chain.back().vertices;
+    faces = chain.back().faces;
+    face_edges = chain.back().face_edges;
+    if (faces.size() < kLodSmallestFaces) break;
+  }
+  return chain;
+}
+}  // namespace s21
@@ -0,0 +1,74 @@
+#ifndef MODEL_MESH_LOD_H
+#define MODEL_MESH_LOD_H
+
+#include <atomic>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "model/arena.h"
+#include "model/mesh_types.h"
+#include "model/parser.h"
+
+namespace s21 {
+// Meshes with fewer faces are always drawn at full detail
+const std::size_t kLodMinFaces = 1 << 17;
+// The chain ends with the first level below this many faces
+const std::size_t kLodSmallestFaces = 1 << 12;
+// Coarsest grid tried, in cells along the longest side of the bounding box
+const unsigned kLodMinGridCells = 8;
+// A level is kept when it has at most this share of the faces of the level
+// before it, otherwise it costs memory without saving much drawing
+const double kLodMaxFaceShare = 0.5;
+// Vertices one thread puts into cells at a time, and the records between
+// two cancellation checks
+const std::size_t kLodBlockVertices = 1 << 16;
+
+// One level of detail of a mesh
+struct MeshLod {
+  std::vector<Coordinate> vertices;
+  std::vector<Face> faces;
+  std::vector<FaceEdgeMask> face_edges;
+  ArenaVector<Edge> edges;
+  // Cells along the longest side of the bounding box
+  unsigned grid_cells = 0;
+  // Time to cluster the level and list its edges
+  double milliseconds = 0.0;
+};
+
+/**
+ * @brief Decimates a mesh by vertex clustering
+ *
+ * The bounding box is cut into cubic cells, grid_cells along its longest
+ * side. All vertices in a cell become one, at their average position, in
+ * the order their cells are first met. Faces left with two corners in one
+ * cell are dropped; the others keep their outline masks, and the edges are
+ * listed by BuildEdgeList(). Clustering a level again with half the cells
+ * gives the same cells as clustering the original, since the averages stay
+ * inside their cells. cancel, when set, is checked every kLodBlockVertices
+ * records and before the edges are listed; a cancelled call returns an
+ * empty level.
+ */
+MeshLod ClusterVertices(std::span<const Coordinate> vertices,
+                        std::span<const Face> faces,
+                        std::span<const FaceEdgeMask> face_edges,
+                        const Bounds &bounds, unsigned grid_cells,
+                        unsigned thread_count,
+                        const std::atomic<bool> *cancel = nullptr);
+
+/**
+ * @brief Builds coarser and coarser levels of a model for distant views
+ *
+ * The first grid has about a quarter as many surface cells as the model has
+ * faces; each next level halves the cells per side and is clustered from
+ * the last level kept, so a level costs about a quarter of the one before.
+ * Empty for models under kLodMinFaces faces and for 64-bit meshes.
+ * cancel, when set, is passed to ClusterVertices() and ends the chain with
+ * the last level finished before it.
+ */
+std::vector<MeshLod> BuildLodChain(const WireframeObject &model,
+                                   unsigned thread_count,
+                                   const std::atomic<bool> *cancel = nullptr);
+}  // namespace s21
+
+#endif  // MODEL_MESH_LOD_H
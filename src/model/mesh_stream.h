@@ -0,0 +1,72 @@
+#ifndef MODEL_MESH_STREAM_H
+#define MODEL_MESH_STREAM_H
+
+#include <cstddef>
+#include <mutex>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "model/mesh_types.h"
+
+namespace s21 {
+
+// Records parsed since the previous batch, appended to the ones before them
+struct MeshBatch {
+  std::vector<Coordinate> vertices;
+  std::vector<Face> faces;
+};
+
+/**
+ * @class MeshStream
+ * @brief Hands a growing prefix of a mesh from the loading threads to the
+ * viewer while the file is still being parsed
+ *
+ * The parser publishes records strictly in file order, and a face is only
+ * published once every vertex it references has been. Concatenating the
+ * batches therefore always yields a drawable mesh, and the finished
+ * WireframeObject starts with exactly the published records unless welding
+ * renumbered them (see WireframeObject::KeepsStreamedPrefix()).
+ */
+class MeshStream {
+ public:
+  void Publish(std::span<const Coordinate> vertices,
+               std::span<const Face> faces) {
+    if (vertices.empty() && faces.empty()) return;
+    MeshBatch batch;
+    batch.vertices.assign(vertices.begin(), vertices.end());
+    batch.faces.assign(faces.begin(), faces.end());
+    std::lock_guard<std::mutex> lock(mutex_);
+    published_vertices_ += vertices.size();
+    published_faces_ += faces.size();
+    pending_.push_back(std::move(batch));
+  }
+
+  // Batches published since the previous call, oldest first
+  std::vector<MeshBatch> TakeBatches() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return std::exchange(pending_, std::vector<MeshBatch>());
+  }
+
+  bool HasBatches() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return !pending_.empty();
+  }
+  std::size_t GetPublishedVertexCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return published_vertices_;
+  }
+  std::size_t GetPublishedFaceCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return published_faces_;
+  }
+
+ private:
+  mutable std::mutex mutex_;
+  std::vector<MeshBatch> pending_;
+  std::size_t published_vertices_ = 0;
+  std::size_t published_faces_ = 0;
+};  // class MeshStream
+}  // namespace s21
+
+#endif  // MODEL_MESH_STREAM_H
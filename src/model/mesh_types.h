@@ -0,0 +1,97 @@
+#ifndef MODEL_MESH_TYPES_H
+#define MODEL_MESH_TYPES_H
+
+#include <cmath>
+#include <cstdint>
+
+namespace s21 {
+struct Coordinate {
+  float x{0.0f}, y{0.0f}, z{0.0f};
+  bool IsValid() const {
+    return !std::isnan(x) && !std::isnan(y) && !std::isnan(z);
+  }
+};
+// The vertex array is passed to OpenGL as tightly packed xyz floats
+static_assert(sizeof(Coordinate) == 3 * sizeof(float));
+struct TextureCoordinate {
+  float u{0.0f}, v{0.0f};
+  bool IsValid() const {
+    return !std::isnan(u) && !std::isnan(v) && u >= -0.01f && u <= 1.01f &&
+           v >= -0.01f && v <= 1.01f;
+  }
+};
+// Zero-based indices of a triangle's corners. An array of 32-bit faces is
+// laid out exactly like a GL_UNSIGNED_INT index buffer.
+template <typename Index>
+struct BasicFace {
+  using IndexType = Index;
+  Index index[3]{0, 0, 0};
+};
+using Face = BasicFace<std::uint32_t>;
+// Only for meshes with more records than 32-bit indices can address
+using WideFace = BasicFace<std::uint64_t>;
+static_assert(sizeof(Face) == 3 * sizeof(std::uint32_t));
+static_assert(sizeof(WideFace) == 3 * sizeof(std::uint64_t));
+// Marks a corner without a texture coordinate or normal
+const std::uint32_t kNoIndex = UINT32_MAX;
+const std::uint64_t kNoWideIndex = UINT64_MAX;
+const Face kNoFace = {{kNoIndex, kNoIndex, kNoIndex}};
+const WideFace kNoWideFace = {{kNoWideIndex, kNoWideIndex, kNoWideIndex}};
+
+// Changes the index type of a face, keeping missing corners missing
+template <typename To, typename From>
+BasicFace<To> ConvertFace(const BasicFace<From> &face) {
+  BasicFace<To> result;
+  for (int i = 0; i < 3; ++i) {
+    result.index[i] = face.index[i] == static_cast<From>(-1)
+                          ? static_cast<To>(-1)
+                          : static_cast<To>(face.index[i]);
+  }
+  return result;
+}
+
+typedef enum {
+  kIndex32 = 0,  // faces stored as Face
+  kIndex64,      // faces stored as WideFace
+} IndexWidthT;
+
+// Bit k is set when the triangle edge from corner k to corner (k + 1) % 3 is
+// part of the outline of the polygon the triangle was cut from
+typedef std::uint8_t FaceEdgeMask;
+const FaceEdgeMask kAllFaceEdges = 0b111;
+
+typedef enum {
+  kTriangulateFan = 0,  // from the first corner, right for convex polygons
+  kTriangulateEarClip,  // also concave ones, needs the vertex positions
+} TriangulationT;
+
+// Zero-based indices of a segment's end points, laid out for GL_LINES
+struct Edge {
+  std::uint32_t index[2]{0, 0};
+};
+static_assert(sizeof(Edge) == 2 * sizeof(std::uint32_t));
+// Axis-aligned box around all vertices, min > max while nothing is loaded
+struct Bounds {
+  Coordinate min{1.0f, 1.0f, 1.0f}, max{-1.0f, -1.0f, -1.0f};
+  bool IsEmpty() const { return min.x > max.x; }
+};
+
+struct Counter {
+  std::uint64_t v = 0, vt = 0, vn = 0, f = 0;
+
+  Counter &operator+=(const Counter &other) {
+    v += other.v;
+    vt += other.vt;
+    vn += other.vn;
+    f += other.f;
+    return *this;
+  }
+  std::uint64_t Total() const { return v + vt + vn + f; }
+};
+
+// Average OBJ bytes per vertex for a typical triangle mesh: one "v" line plus
+// two "f" lines. Used to pre-reserve storage from the file size.
+const std::uintmax_t kBytesPerVertexEstimate = 80;
+}  // namespace s21
+
+#endif  // MODEL_MESH_TYPES_H
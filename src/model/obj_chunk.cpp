@@ -0,0 +1,319 @@
+#include "model/obj_chunk.h"
+
+namespace s21 {
+
+ErrorCode ObjChunk::Parse(std::string_view buffer) {
+  ErrorCode result_code = success_code;
+  LineScanner scanner(buffer);
+  std::string_view line;
+  // End of the input covered by the last progress report
+  const char *reported = buffer.data();
+  std::uint64_t lines = 0;
+  try {
+    while (result_code == success_code && scanner.Next(line)) {
+      result_code = ParseLine(line);
+      if (++lines % kProgressLines == 0 && result_code == success_code) {
+        const char *line_end = line.data() + line.size();
+        result_code = CheckPoint(line_end - reported);
+        reported = line_end;
+      }
+    }
+    if (result_code == success_code) {
+      result_code = CheckPoint(buffer.data() + buffer.size() - reported);
+    }
+  } catch (const std::bad_alloc &) {
+    if (!is_speculative_) LogError("ObjChunk", memory_error);
+    result_code = memory_error;
+  }
+  return result_code;
+}
+
+ErrorCode ObjChunk::ParseLine(std::string_view line) {
+  std::size_t start = 0;
+  while (start < line.size() && ObjTokenizer::IsBlank(line[start])) start++;
+  std::string_view record = line.substr(start);
+
+  // Branch on the first two bytes instead of looking the prefix up by name
+  auto is_end = [&record](std::size_t i) {
+    return i >= record.size() || ObjTokenizer::IsBlank(record[i]);
+  };
+  ParseFunction parse = nullptr;
+  std::size_t prefix_size = 1;
+  if (!record.empty() && record[0] == 'v') {
+    if (is_end(1)) {
+      parse = &ObjChunk::ParseVertex;
+    } else if (is_end(2)) {
+      prefix_size = 2;
+      if (record[1] == 't') parse = &ObjChunk::ParseTextureCoordinate;
+      if (record[1] == 'n') parse = &ObjChunk::ParseNormal;
+    }
+  } else if (!record.empty() && record[0] == 'f' && is_end(1)) {
+    parse = &ObjChunk::ParseFace;
+  }
+  // Comments, groups, materials and other records are skipped
+
+  if (parse != nullptr) {
+    ObjTokenizer tokenizer(record.substr(prefix_size));
+    if (!(this->*parse)(tokenizer)) {
+      if (!is_speculative_) {
+        LogError("ParseLine", "Invalid format in line: " + std::string(line));
+      }
+      return invalid_format;
+    }
+  }
+  return success_code;
+}
+
+ErrorCode ObjChunk::CheckPoint(std::uint64_t bytes) {
+  if (memory_budget_ != 0 && MemoryUsage() > memory_budget_) {
+    if (!is_speculative_) {
+      LogError("ObjChunk", "Model exceeds the memory budget of " +
+                               std::to_string(memory_budget_ >> 20) + " MB");
+    }
+    return memory_error;
+  }
+  return ReportProgress(bytes);
+}
+
+std::uint64_t ObjChunk::MemoryUsage() const {
+  return vertices_.capacity() * sizeof(Coordinate) +
+         textures_.capacity() * sizeof(TextureCoordinate) +
+         normals_.capacity() * sizeof(Coordinate) +
+         (faces_.capacity() + texture_faces_.capacity() +
+          normal_faces_.capacity()) *
+             sizeof(Face) +
+         (wide_faces_.capacity() + wide_texture_faces_.capacity() +
+          wide_normal_faces_.capacity()) *
+             sizeof(WideFace) +
+         face_edges_.capacity() * sizeof(FaceEdgeMask) +
+         polygons_.capacity() * sizeof(PolygonRun);
+}
+
+void ObjChunk::Widen() {
+  if (index_width_ == kIndex64) return;
+  auto widen = [](ArenaVector<Face> &from, ArenaVector<WideFace> &to) {
+    to.reserve(from.capacity());
+    for (const Face &face : from) {
+      to.push_back(ConvertFace<std::uint64_t>(face));
+    }
+    ReleaseStorage(from);
+  };
+  widen(faces_, wide_faces_);
+  widen(texture_faces_, wide_texture_faces_);
+  widen(normal_faces_, wide_normal_faces_);
+  index_width_ = kIndex64;
+}
+
+void ObjChunk::SetArena(Arena *arena) {
+  vertices_ = ArenaVector<Coordinate>(ArenaAllocator<Coordinate>(arena));
+  textures_ =
+      ArenaVector<TextureCoordinate>(ArenaAllocator<TextureCoordinate>(arena));
+  normals_ = ArenaVector<Coordinate>(ArenaAllocator<Coordinate>(arena));
+  faces_ = ArenaVector<Face>(ArenaAllocator<Face>(arena));
+  texture_faces_ = ArenaVector<Face>(ArenaAllocator<Face>(arena));
+  normal_faces_ = ArenaVector<Face>(ArenaAllocator<Face>(arena));
+  wide_faces_ = ArenaVector<WideFace>(ArenaAllocator<WideFace>(arena));
+  wide_texture_faces_ = ArenaVector<WideFace>(ArenaAllocator<WideFace>(arena));
+  wide_normal_faces_ = ArenaVector<WideFace>(ArenaAllocator<WideFace>(arena));
+  face_edges_ = ArenaVector<FaceEdgeMask>(ArenaAllocator<FaceEdgeMask>(arena));
+  polygons_ = ArenaVector<PolygonRun>(ArenaAllocator<PolygonRun>(arena));
+}
+
+void ObjChunk::ReserveByFileSize(std::uintmax_t file_size) {
+  std::uintmax_t vertices = file_size / kBytesPerVertexEstimate;
+  // Keep the guess inside the budget: a vertex and two faces per estimate
+  if (memory_budget_ != 0) {
+    vertices = std::min<std::uintmax_t>(
+        vertices, memory_budget_ / (sizeof(Coordinate) + 2 * sizeof(Face)));
+  }
+  // Faces are reserved by the first one, point clouds never pay for them
+  reserved_faces_ = vertices * 2;
+  try {
+    vertices_.reserve(vertices);
+  } catch (const std::bad_alloc &) {
+    // The estimate is only a hint, storage still grows on demand
+  }
+}
+
+void ObjChunk::ReserveFaces() {
+  try {
+    if (index_width_ == kIndex32) {
+      faces_.reserve(reserved_faces_);
+    } else {
+      wide_faces_.reserve(reserved_faces_);
+    }
+  } catch (const std::bad_alloc &) {
+  }
+  reserved_faces_ = 0;
+}
+
+ErrorCode ObjChunk::ReportProgress(std::uint64_t bytes) {
+  // Viewers draw 32-bit indices only, a widened chunk stops publishing
+  if (stream_ != nullptr && !is_speculative_ && index_width_ == kIndex32) {
+    // Faces of a regular chunk only reference records read before them
+    stream_->Publish(std::span<const Coordinate>(vertices_).subspan(
+                         published_vertices_),
+                     std::span<const Face>(faces_).subspan(published_faces_));
+    published_vertices_ = vertices_.size();
+    published_faces_ = faces_.size();
+  }
+  if (progress_ == nullptr) return success_code;
+  std::uint64_t records = count_.Total();
+  progress_->Add(bytes, records - reported_records_);
+  reported_records_ = records;
+  return progress_->IsCancelled() ? load_cancelled : success_code;
+}
+
+bool ObjChunk::ReferencesFit(const Counter &preceding) const {
+  return reach_.v <= preceding.v && reach_.vt <= preceding.vt &&
+         reach_.vn <= preceding.vn;
+}
+
+bool ObjChunk::ParseVertex(ObjTokenizer &tokenizer) {
+  Coordinate vertex;
+  if (!tokenizer.NextFloat(vertex.x) || !tokenizer.NextFloat(vertex.y) ||
+      !tokenizer.NextFloat(vertex.z)) {
+    return false;
+  }
+  if (!vertex.IsValid()) return false;
+  vertices_.push_back(vertex);
+  count_.v++;
+  return true;
+}
+
+bool ObjChunk::ParseTextureCoordinate(ObjTokenizer &tokenizer) {
+  TextureCoordinate texture;
+  if (!tokenizer.NextFloat(texture.u) || !tokenizer.NextFloat(texture.v)) {
+    return false;
+  }
+  if (!texture.IsValid()) return false;
+  textures_.push_back(texture);
+  count_.vt++;
+  return true;
+}
+
+bool ObjChunk::ParseNormal(ObjTokenizer &tokenizer) {
+  Coordinate normal;
+  if (!tokenizer.NextFloat(normal.x) || !tokenizer.NextFloat(normal.y) ||
+      !tokenizer.NextFloat(normal.z)) {
+    return false;
+  }
+  if (!normal.IsValid()) return false;
+  // Normal vector components should be in [-1, 1]
+  if (std::abs(normal.x) > 1.01f || std::abs(normal.y) > 1.01f ||
+      std::abs(normal.z) > 1.01f) {
+    return false;
+  }
+  normals_.push_back(normal);
+  count_.vn++;
+  return true;
+}
+
+bool ObjChunk::ParseFace(ObjTokenizer &tokenizer) {
+  // The polygon is fanned out while it is read: every corner after the
+  // second closes triangle (first, previous, current)
+  std::uint64_t first_face = count_.f;
+  std::uint64_t corner_count = 0;
+  FaceCorner first, previous, corner;
+  while (!tokenizer.AtEnd()) {
+    if (!ParseCorner(tokenizer, corner)) return false;
+    if (corner_count == 0) first = corner;
+    if (corner_count >= 2) AppendTriangle(first, previous, corner);
+    previous = corner;
+    corner_count++;
+  }
+  if (corner_count < 3) return false;
+  FinishPolygon(first_face, corner_count);
+  return true;
+}
+
+void ObjChunk::AppendPolygon(std::span<const FaceCorner> corners) {
+  std::uint64_t first_face = count_.f;
+  for (std::size_t i = 2; i < corners.size(); ++i) {
+    AppendTriangle(corners[0], corners[i - 1], corners[i]);
+  }
+  FinishPolygon(first_face, corners.size());
+}
+
+void ObjChunk::FinishPolygon(std::uint64_t first_face,
+                             std::uint64_t corner_count) {
+  std::uint64_t triangle_count = corner_count - 2;
+  if (triangle_count > 1 || !face_edges_.empty()) {
+    // Plain triangles before the first polygon have all edges on the outline
+    face_edges_.resize(first_face, kAllFaceEdges);
+    for (std::uint64_t i = 0; i < triangle_count; ++i) {
+      // Only the first and the last triangle touch the first corner's edges
+      face_edges_.push_back((i == 0 ? 0b001 : 0) | 0b010 |
+                            (i + 1 == triangle_count ? 0b100 : 0));
+    }
+  }
+  if (triangle_count > 1 && triangulation_ == kTriangulateEarClip) {
+    polygons_.push_back({first_face, corner_count});
+  }
+}
+
+bool ObjChunk::ParseCorner(ObjTokenizer &tokenizer, FaceCorner &corner) {
+  // Only references to records that were already read are valid
+  return tokenizer.NextFaceCorner(corner) &&
+         CheckReference(corner.v, count_.v, reach_.v) &&
+         CheckReference(corner.vt, count_.vt, reach_.vt) &&
+         CheckReference(corner.vn, count_.vn, reach_.vn);
+}
+
+void ObjChunk::AppendTriangle(const FaceCorner &a, const FaceCorner &b,
+                              const FaceCorner &c) {
+  WideFace face, texture_face, normal_face;
+  bool has_texture = false, has_normal = false;
+  std::uint64_t largest_index = 0;
+  const FaceCorner *corners[3] = {&a, &b, &c};
+  for (int i = 0; i < 3; i++) {
+    const FaceCorner &corner = *corners[i];
+    face.index[i] = corner.v - 1;
+    texture_face.index[i] = corner.vt ? corner.vt - 1 : kNoWideIndex;
+    normal_face.index[i] = corner.vn ? corner.vn - 1 : kNoWideIndex;
+    has_texture = has_texture || corner.vt;
+    has_normal = has_normal || corner.vn;
+    largest_index = std::max({largest_index, corner.v, corner.vt, corner.vn});
+  }
+  // largest_index is one-based: the zero-based index must stay below the limit
+  if (largest_index > narrow_limit_) Widen();
+  if (count_.f == 0 && reserved_faces_ != 0) ReserveFaces();
+  if (index_width_ == kIndex32) {
+    AppendFace(faces_, texture_faces_, normal_faces_, face, texture_face,
+               normal_face, has_texture, has_normal);
+  } else {
+    AppendFace(wide_faces_, wide_texture_faces_, wide_normal_faces_, face,
+               texture_face, normal_face, has_texture, has_normal);
+  }
+  count_.f++;
+}
+
+bool ObjChunk::CheckReference(std::uint64_t index, std::uint64_t count,
+                              std::uint64_t &reach) {
+  if (!is_speculative_) return index <= count;
+  if (index > count) reach = std::max(reach, index - count);
+  return true;
+}
+
+template <typename F>
+void ObjChunk::AppendFace(ArenaVector<F> &faces,
+                          ArenaVector<F> &texture_faces,
+                          ArenaVector<F> &normal_faces, const WideFace &face,
+                          const WideFace &texture_face,
+                          const WideFace &normal_face, bool has_texture,
+                          bool has_normal) {
+  using Index = typename F::IndexType;
+  faces.push_back(ConvertFace<Index>(face));
+  // Faces before the first one with an attribute didn't have it either
+  const F missing = ConvertFace<Index>(kNoWideFace);
+  if (has_texture || !texture_faces.empty()) {
+    texture_faces.resize(count_.f, missing);
+    texture_faces.push_back(ConvertFace<Index>(texture_face));
+  }
+  if (has_normal || !normal_faces.empty()) {
+    normal_faces.resize(count_.f, missing);
+    normal_faces.push_back(ConvertFace<Index>(normal_face));
+  }
+}
+
+}  // namespace s21
@@ -0,0 +1,138 @@
+#ifndef MODEL_OBJ_CHUNK_H
+#define MODEL_OBJ_CHUNK_H
+
+#include <algorithm>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "model/arena.h"
+#include "model/errors.h"
+#include "model/load_progress.h"
+#include "model/mesh_stream.h"
+#include "model/mesh_types.h"
+#include "model/obj_tokenizer.h"
+#include "model/simd_scanner.h"
+#include "model/triangulation.h"
+
+namespace s21 {
+
+/**
+ * @class ObjChunk
+ * @brief Records parsed from a run of whole lines of an OBJ file
+ *
+ * A chunk validates every record and stores it in its own arrays. A face may
+ * only reference records that appear earlier in the file. The regular chunk
+ * checks this per face and logs the first invalid line.
+ *
+ * A speculative chunk is parsed in parallel with its neighbours and doesn't
+ * know how many records precede it. It records how far its faces reach past
+ * its own records instead. ReferencesFit() finishes the check once the
+ * preceding counts are known. Speculative chunks never log: the caller
+ * re-parses serially to report the exact line.
+ *
+ * Faces with more than three corners are fanned out into triangles while
+ * they are read, with an outline mask per triangle in face_edges_. With
+ * kTriangulateEarClip the fanned polygons are also listed in polygons_ for
+ * the owner to re-triangulate once all vertex positions are known.
+ *
+ * Faces are stored with 32-bit indices. The first face referencing a record
+ * past narrow_limit switches the chunk to 64-bit WideFace storage; the narrow
+ * arrays are converted and left empty.
+ *
+ * A chunk with a memory budget fails with memory_error once its arrays grow
+ * past it. With a LoadProgress attached, Parse() reports its progress every
+ * kProgressLines lines and stops with load_cancelled when asked to. A regular
+ * chunk with a MeshStream attached publishes its new records at the same
+ * points; speculative chunks are published whole by their owner once the
+ * chunks before them are known to be valid.
+ */
+class ObjChunk {
+ public:
+  explicit ObjChunk(bool is_speculative = false,
+                    std::uint64_t narrow_limit = kNoIndex)
+      : is_speculative_(is_speculative), narrow_limit_(narrow_limit) {}
+
+  ErrorCode Parse(std::string_view buffer);
+  ErrorCode ParseLine(std::string_view line);
+  // Fans out a polygon of at least three corners that were already checked
+  // against the records of the chunk, for loaders of binary formats
+  void AppendPolygon(std::span<const FaceCorner> corners);
+  // Enforces the memory budget and reports bytes parsed since the last call
+  ErrorCode CheckPoint(std::uint64_t bytes);
+  void ReserveByFileSize(std::uintmax_t file_size);
+  bool ReferencesFit(const Counter &preceding) const;
+  void SetProgress(LoadProgress *progress) { progress_ = progress; }
+  void SetStream(MeshStream *stream) { stream_ = stream; }
+  // 0 = unlimited
+  void SetMemoryBudget(std::uint64_t bytes) { memory_budget_ = bytes; }
+  // Places the arrays, which must still be empty, in arena; nullptr = heap
+  void SetArena(Arena *arena);
+  void SetTriangulation(TriangulationT triangulation) {
+    triangulation_ = triangulation;
+  }
+  std::uint64_t MemoryUsage() const;
+  IndexWidthT GetIndexWidth() const { return index_width_; }
+  void Widen();
+
+ public:
+  ArenaVector<Coordinate> vertices_;
+  ArenaVector<TextureCoordinate> textures_;
+  ArenaVector<Coordinate> normals_;
+  ArenaVector<Face> faces_;
+  // Empty until a face references a texture coordinate or normal,
+  // then as long as faces_
+  ArenaVector<Face> texture_faces_;
+  ArenaVector<Face> normal_faces_;
+  // The same three arrays after the chunk switched to 64-bit indices
+  ArenaVector<WideFace> wide_faces_;
+  ArenaVector<WideFace> wide_texture_faces_;
+  ArenaVector<WideFace> wide_normal_faces_;
+  // Empty until a face with more than three corners is read, then as long
+  // as the face array in use
+  ArenaVector<FaceEdgeMask> face_edges_;
+  // Polygons to ear-clip, kTriangulateEarClip only
+  ArenaVector<PolygonRun> polygons_;
+  Counter count_;
+
+ private:
+  using ParseFunction = bool (ObjChunk::*)(ObjTokenizer &);
+  bool ParseVertex(ObjTokenizer &tokenizer);
+  bool ParseTextureCoordinate(ObjTokenizer &tokenizer);
+  bool ParseNormal(ObjTokenizer &tokenizer);
+  bool ParseFace(ObjTokenizer &tokenizer);
+  bool ParseCorner(ObjTokenizer &tokenizer, FaceCorner &corner);
+  // Outline masks and the ear clipping list of a fanned polygon
+  void FinishPolygon(std::uint64_t first_face, std::uint64_t corner_count);
+  void AppendTriangle(const FaceCorner &a, const FaceCorner &b,
+                      const FaceCorner &c);
+  bool CheckReference(std::uint64_t index, std::uint64_t count,
+                      std::uint64_t &reach);
+  template <typename F>
+  void AppendFace(ArenaVector<F> &faces, ArenaVector<F> &texture_faces,
+                  ArenaVector<F> &normal_faces, const WideFace &face,
+                  const WideFace &texture_face, const WideFace &normal_face,
+                  bool has_texture, bool has_normal);
+  void ReserveFaces();
+  ErrorCode ReportProgress(std::uint64_t bytes);
+
+  bool is_speculative_;
+  std::uint64_t narrow_limit_;
+  IndexWidthT index_width_{kIndex32};
+  std::uint64_t memory_budget_{0};
+  TriangulationT triangulation_{kTriangulateFan};
+  // Face storage ReserveByFileSize() asked for, taken by the first face
+  std::uintmax_t reserved_faces_{0};
+  LoadProgress *progress_{nullptr};
+  std::uint64_t reported_records_{0};
+  MeshStream *stream_{nullptr};
+  std::size_t published_vertices_{0};
+  std::size_t published_faces_{0};
+  // Largest (index - records read so far) over all face corners, 0 when
+  // every reference points back
+  Counter reach_;
+};  // class ObjChunk
+}  // namespace s21
+
+#endif  // MODEL_OBJ_CHUNK_H
@@ -0,0 +1,106 @@
+#ifndef MODEL_OBJ_TOKENIZER_H
+#define MODEL_OBJ_TOKENIZER_H
+
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <string_view>
+#include <system_error>
+
+namespace s21 {
+
+// Indices of one face corner, 0 = component is absent
+struct FaceCorner {
+  std::uint64_t v{0}, vt{0}, vn{0};
+};
+
+/**
+ * @class ObjTokenizer
+ * @brief Locale-free scanner over the arguments of a single OBJ record
+ *
+ * Numbers are converted with std::from_chars straight from the line bytes, so
+ * parsing neither depends on the global locale nor needs null-terminated
+ * input. Every Next*() call skips leading blanks, consumes exactly one token
+ * and fails if the token is not entirely a value of the requested kind.
+ */
+class ObjTokenizer {
+ public:
+  explicit ObjTokenizer(std::string_view line)
+      : cursor_(line.data()), end_(line.data() + line.size()) {}
+
+  std::string_view NextToken() {
+    SkipBlanks();
+    const char *begin = cursor_;
+    while (cursor_ < end_ && !IsBlank(*cursor_)) cursor_++;
+    return std::string_view(begin, cursor_ - begin);
+  }
+
+  bool NextFloat(float &value) {
+    SkipBlanks();
+    // from_chars doesn't accept an explicit plus sign; a second sign after
+    // it is refused, as istream extraction did
+    if (cursor_ < end_ && *cursor_ == '+') {
+      cursor_++;
+      if (cursor_ < end_ && (*cursor_ == '-' || *cursor_ == '+')) return false;
+    }
+    auto [ptr, ec] = std::from_chars(cursor_, end_, value);
+    if (ec != std::errc() || !std::isfinite(value)) return false;
+    cursor_ = ptr;
+    return AtTokenEnd();
+  }
+
+  /**
+   * @brief Reads a face corner in "v", "v/vt", "v//vn" or "v/vt/vn" form
+   * @param corner Receives 1-based indices, absent components stay 0
+   */
+  bool NextFaceCorner(FaceCorner &corner) {
+    SkipBlanks();
+    corner = FaceCorner();
+    if (!ReadIndex(corner.v)) return false;
+    if (cursor_ < end_ && *cursor_ == '/') {
+      cursor_++;
+      if (cursor_ < end_ && *cursor_ == '/') {
+        cursor_++;
+        if (!ReadIndex(corner.vn)) return false;
+      } else {
+        if (!ReadIndex(corner.vt)) return false;
+        if (cursor_ < end_ && *cursor_ == '/') {
+          cursor_++;
+          if (!ReadIndex(corner.vn)) return false;
+        }
+      }
+    }
+    return AtTokenEnd();
+  }
+
+  // True once only blanks or a trailing comment are left
+  bool AtEnd() {
+    SkipBlanks();
+    return cursor_ == end_ || *cursor_ == '#';
+  }
+
+  static bool IsBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+  }
+
+ private:
+  void SkipBlanks() {
+    while (cursor_ < end_ && IsBlank(*cursor_)) cursor_++;
+  }
+
+  bool AtTokenEnd() const { return cursor_ == end_ || IsBlank(*cursor_); }
+
+  // OBJ indices are 1-based, so 0 is free to mark an absent component
+  bool ReadIndex(std::uint64_t &value) {
+    auto [ptr, ec] = std::from_chars(cursor_, end_, value);
+    if (ec != std::errc() || value < 1) return false;
+    cursor_ = ptr;
+    return true;
+  }
+
+  const char *cursor_;
+  const char *end_;
+};  // class ObjTokenizer
+}  // namespace s21
+
+#endif  // MODEL_OBJ_TOKENIZER_H
@@ -0,0 +1,66 @@
+#ifndef MODEL_PARALLEL_H
+#define MODEL_PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace s21 {
+
+// 0 means "one thread per hardware thread"
+inline unsigned ResolveThreadCount(unsigned requested) {
+  if (requested != 0) return requested;
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+/**
+ * @brief Runs task(i) for every i in [0, count) on up to thread_count threads
+ *
+ * Work items are handed out one at a time, so items of uneven cost balance
+ * across threads. The calling thread takes part in the work. The first
+ * exception a task throws stops handing out items and is rethrown on the
+ * calling thread once every worker has joined, as in a serial loop. When
+ * the system refuses to start a thread, the items run on the threads
+ * already started.
+ */
+template <typename Task>
+void ParallelFor(std::size_t count, unsigned thread_count, Task task) {
+  std::size_t threads =
+      std::min<std::size_t>(ResolveThreadCount(thread_count), count);
+  if (threads <= 1) {
+    for (std::size_t i = 0; i < count; ++i) task(i);
+    return;
+  }
+
+  std::atomic<std::size_t> next_item{0};
+  std::exception_ptr error;
+  std::mutex error_mutex;
+  auto worker = [&] {
+    try {
+      for (std::size_t i = next_item++; i < count; i = next_item++) task(i);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(error_mutex);
+      if (!error) error = std::current_exception();
+      next_item = count;
+    }
+  };
+  std::vector<std::thread> workers;
+  try {
+    workers.reserve(threads - 1);
+    for (std::size_t i = 1; i < threads; ++i) workers.emplace_back(worker);
+  } catch (const std::exception &) {
+    // No more threads could be started: the ones running and this one
+    // share the remaining items
+  }
+  worker();
+  for (auto &thread : workers) thread.join();
+  if (error) std::rethrow_exception(error);
+}
+
+}  // namespace s21
+
+#endif  // MODEL_PARALLEL_H
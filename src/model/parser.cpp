@@ -1,28 +1,180 @@
 #include "model/parser.h"
 
+#include <unistd.h>
+
+#include <chrono>
+
+#include "model/edge_list.h"
+#include "model/gltf_loader.h"
+#include "model/mesh_cache.h"
+#include "model/vertex_weld.h"
+
 namespace s21 {
+namespace {
+// Face arrays of a merged mesh, with either index width
+template <typename F>
+struct FaceColumns {
+  ArenaVector<F> faces, texture_faces, normal_faces;
+};
+
+// Address space for one load: the chunks, their growth and the merged mesh
+std::shared_ptr<Arena> MakeLoadArena(const LoadOptions &options) {
+  std::uint64_t budget = ResolveMemoryBudget(options.memory_budget);
+  if (budget == 0) return nullptr;
+  auto arena = std::make_shared<Arena>(
+      std::max(budget * kArenaBudgetFactor, kMinArenaBytes));
+  // Without a reservation (strict overcommit) the heap takes over
+  return arena->IsReserved() ? arena : nullptr;
+}
+
+// Settings every chunk of a load shares; streaming is up to the caller
+void ConfigureChunk(ObjChunk &chunk, Arena *arena,
+                    const LoadOptions &options) {
+  chunk.SetArena(arena);
+  chunk.SetProgress(options.progress);
+  chunk.SetMemoryBudget(ResolveMemoryBudget(options.memory_budget));
+  chunk.SetTriangulation(options.triangulation);
+}
+
+// Rewrites the vertex indices of faces after a weld; the records
+// are copied since the array may view a mapped file
+template <typename T>
+void RemapIndices(MeshArray<T> &records,
+                  const std::vector<std::uint64_t> &remap,
+                  unsigned thread_count) {
+  if (records.empty()) return;
+  ArenaVector<T> remapped(records.begin(), records.end());
+  std::size_t block_count =
+      (remapped.size() + kWeldBlockCorners - 1) / kWeldBlockCorners;
+  ParallelFor(block_count, thread_count, [&](std::size_t block) {
+    std::size_t end =
+        std::min(remapped.size(), (block + 1) * kWeldBlockCorners);
+    for (std::size_t i = block * kWeldBlockCorners; i < end; ++i) {
+      for (auto &index : remapped[i].index) {
+        index = static_cast<std::remove_reference_t<decltype(index)>>(
+            remap[index]);
+      }
+    }
+  });
+  records = std::move(remapped);
+}
+
+// Copies one array of every chunk to where the chunk starts in the merged
+// array and frees it; chunks without the array leave the filler
+template <typename T>
+ArenaVector<T> MergeColumn(std::vector<ObjChunk> &chunks,
+                           const std::vector<Counter> &offsets,
+                           std::uint64_t count, unsigned thread_count,
+                           ArenaVector<T> ObjChunk::*column, T filler,
+                           Arena *arena) {
+  bool is_present = false;
+  for (const ObjChunk &chunk : chunks) {
+    is_present = is_present || !(chunk.*column).empty();
+  }
+  ArenaVector<T> merged(is_present ? count : 0, filler,
+                        ArenaAllocator<T>(arena));
+  if (!is_present) return merged;
+  ParallelFor(chunks.size(), thread_count, [&](std::size_t i) {
+    ArenaVector<T> &from = chunks[i].*column;
+    std::copy(from.begin(), from.end(), merged.begin() + offsets[i].f);
+    ReleaseStorage(from);
+  });
+  return merged;
+}
+
+template <typename F>
+FaceColumns<F> MergeFaceColumns(std::vector<ObjChunk> &chunks,
+                                const std::vector<Counter> &offsets,
+                                std::uint64_t face_count,
+                                unsigned thread_count,
+                                ArenaVector<F> ObjChunk::*faces,
+                                ArenaVector<F> ObjChunk::*texture_faces,
+                                ArenaVector<F> ObjChunk::*normal_faces,
+                                Arena *arena) {
+  // Faces without a texture coordinate or normal get the missing corner
+  const F missing = ConvertFace<typename F::IndexType>(kNoWideFace);
+  return {MergeColumn(chunks, offsets, face_count, thread_count, faces, F(),
+                      arena),
+          MergeColumn(chunks, offsets, face_count, thread_count,
+                      texture_faces, missing, arena),
+          MergeColumn(chunks, offsets, face_count, thread_count, normal_faces,
+                      missing, arena)};
+}
+}  // namespace
+
 int WireframeObject::next_id_ = 0;
 
-WireframeObject::WireframeObject(const std::string file_path) {
-  std::ifstream file(file_path);
-  if (!file.is_open()) {
-    LogError("WireframeObject", file_not_found);
-  } else {
-    if (AllocateMemory(file) == success_code) {
-      id_ = next_id_++;
-      GetValues(file);
-      AssignName(file_path);
+std::uint64_t ResolveMemoryBudget(std::uint64_t memory_budget) {
+  if (memory_budget != 0) return memory_budget;
+  long pages = sysconf(_SC_PHYS_PAGES);
+  long page_size = sysconf(_SC_PAGE_SIZE);
+  if (pages <= 0 || page_size <= 0) return 0;
+  return static_cast<std::uint64_t>(pages) * page_size / 4 * 3;
+}
+
+WireframeObject::WireframeObject(const std::string file_path,
+                                 const LoadOptions &options) {
+  ErrorCode result_code = file_not_found;
+  bool is_parsed = false;
+
+  const MeshFormat &format = DetectMeshFormat(file_path);
+  if (format.load != nullptr) {
+    result_code = ParseBinary(file_path, format, options);
+    is_parsed = true;
+  } else if (format.format == kFormatGltf) {
+    result_code = GltfLoader::Load(file_path, options, *this);
+    is_parsed = true;
+  } else if (format.format == kFormatObjGzip) {
+    GzipReader reader(file_path);
+    if (!reader.IsOpen()) {
+      LogError("WireframeObject", file_not_found);
+    } else {
+      if (options.progress != nullptr) {
+        options.progress->SetTotalBytes(reader.GetSizeHint());
+      }
+      result_code = ParseGzip(reader, options);
+    }
+    is_parsed = true;
+  }
+
+  if (!is_parsed && options.mode == kLoadMapped) {
+    MappedFile mapped_file(file_path);
+    if (mapped_file.IsMapped()) {
+      if (options.progress != nullptr) {
+        options.progress->SetTotalBytes(mapped_file.GetView().size());
+      }
+      result_code = ParseBuffer(mapped_file.GetView(), options);
+      is_parsed = true;
+    }
+  }
+
+  if (!is_parsed) {
+    std::ifstream file(file_path);
+    if (!file.is_open()) {
+      LogError("WireframeObject", file_not_found);
+    } else {
+      std::error_code error;
+      std::uintmax_t file_size = std::filesystem::file_size(file_path, error);
+      bool is_reserved = options.reserve_by_file_size && !error;
+      if (options.progress != nullptr) {
+        options.progress->SetTotalBytes(error ? 0 : file_size);
+      }
+      result_code =
+          ParseStream(file, is_reserved ? file_size : 0, options);
+      file.close();
     }
-    file.close();
+  }
+
+  if (result_code == success_code) {
+    id_ = next_id_++;
+    AssignName(file_path);
+  } else {
+    Clear();
   }
 }
 
 WireframeObject::~WireframeObject() {
-  vertices_.clear();
-  textures_.clear();
-  normals_.clear();
-  faces_.clear();
-  count_ = Counter();
+  Clear();
   id_ = -1;
   name_.clear();
 }
@@ -33,7 +185,17 @@ WireframeObject::WireframeObject(const WireframeObject &other)
       faces_(other.faces_),
       textures_(other.textures_),
       normals_(other.normals_),
-      count_(other.count_) {
+      texture_faces_(other.texture_faces_),
+      normal_faces_(other.normal_faces_),
+      wide_faces_(other.wide_faces_),
+      wide_texture_faces_(other.wide_texture_faces_),
+      wide_normal_faces_(other.wide_normal_faces_),
+      index_width_(other.index_width_),
+      face_edges_(other.face_edges_),
+      edges_(other.edges_),
+      bounds_(other.bounds_),
+      count_(other.count_),
+      weld_stats_(other.weld_stats_) {
   id_ = next_id_++;
 }
 
@@ -44,220 +206,568 @@ WireframeObject &WireframeObject::operator=(const WireframeObject &other) {
     faces_ = other.faces_;
     textures_ = other.textures_;
     normals_ = other.normals_;
+    texture_faces_ = other.texture_faces_;
+    normal_faces_ = other.normal_faces_;
+    wide_faces_ = other.wide_faces_;
+    wide_texture_faces_ = other.wide_texture_faces_;
+    wide_normal_faces_ = other.wide_normal_faces_;
+    index_width_ = other.index_width_;
+    face_edges_ = other.face_edges_;
+    edges_ = other.edges_;
+    bounds_ = other.bounds_;
     count_ = other.count_;
+    weld_stats_ = other.weld_stats_;
     id_ = next_id_++;
+    // The copies are on the heap, the old arrays are gone
+    arena_.reset();
   }
   return *this;
 }
 
-ErrorCode WireframeObject::AllocateMemory(std::ifstream &file) {
-  const std::map<std::string, InputFunction> inspect_types = {
-      {"v", &WireframeObject::CheckVertex},
-      {"vt", &WireframeObject::CheckTexture},
-      {"vn", &WireframeObject::CheckNormal},
-      {"f", &WireframeObject::CheckFace}};
-
-  std::string line;
-  ErrorCode result_code = success_code;
+WireframeObject::WireframeObject(WireframeObject &&other) noexcept
+    : name_(std::move(other.name_)),
+      arena_(std::move(other.arena_)),
+      vertices_(std::move(other.vertices_)),
+      faces_(std::move(other.faces_)),
+      textures_(std::move(other.textures_)),
+      normals_(std::move(other.normals_)),
+      texture_faces_(std::move(other.texture_faces_)),
+      normal_faces_(std::move(other.normal_faces_)),
+      wide_faces_(std::move(other.wide_faces_)),
+      wide_texture_faces_(std::move(other.wide_texture_faces_)),
+      wide_normal_faces_(std::move(other.wide_normal_faces_)),
+      index_width_(other.index_width_),
+      face_edges_(std::move(other.face_edges_)),
+      edges_(std::move(other.edges_)),
+      bounds_(other.bounds_),
+      id_(other.id_),
+      count_(other.count_),
+      weld_stats_(other.weld_stats_) {
+  // The mesh changes owner but stays the same object, so it keeps its id
+  other.Clear();
+  other.id_ = -1;
+  other.name_.clear();
+}
 
-  while (std::getline(file, line)) {
-    if (line.empty() || line[0] == '#') continue;
+WireframeObject &WireframeObject::operator=(WireframeObject &&other) noexcept {
+  if (this != &other) {
+    name_ = std::move(other.name_);
+    vertices_ = std::move(other.vertices_);
+    faces_ = std::move(other.faces_);
+    textures_ = std::move(other.textures_);
+    normals_ = std::move(other.normals_);
+    texture_faces_ = std::move(other.texture_faces_);
+    normal_faces_ = std::move(other.normal_faces_);
+    wide_faces_ = std::move(other.wide_faces_);
+    wide_texture_faces_ = std::move(other.wide_texture_faces_);
+    wide_normal_faces_ = std::move(other.wide_normal_faces_);
+    index_width_ = other.index_width_;
+    face_edges_ = std::move(other.face_edges_);
+    edges_ = std::move(other.edges_);
+    bounds_ = other.bounds_;
+    id_ = other.id_;
+    count_ = other.count_;
+    weld_stats_ = other.weld_stats_;
+    // Only now the arrays this object had are freed and its arena unused
+    arena_ = std::move(other.arena_);
+    other.Clear();
+    other.id_ = -1;
+    other.name_.clear();
+  }
+  return *this;
+}
 
-    std::istringstream iss(line);
-    std::string prefix;
-    iss >> prefix;
+std::optional<WireframeObject> WireframeObject::Load(
+    const std::string &file_path, const LoadOptions &options) {
+  MeshCache cache(options.cache_dir);
+  std::optional<MeshCacheKey> key;
+  std::optional<WireframeObject> model;
+  if (options.use_cache) {
+    key = MeshCache::MakeKey(file_path, options.thread_count);
+    if (key) key->triangulation = options.triangulation;
+    model = key ? cache.Fetch(*key) : std::nullopt;
+    if (model) {
+      model->AssignName(file_path);
+      if (options.progress != nullptr) {
+        options.progress->SetTotalBytes(key->size);
+        options.progress->Add(key->size, model->GetVertexCount() +
+                                             model->GetFaceCount());
+      }
+    }
+  }
 
-    auto it = inspect_types.find(prefix);
-    if (it != inspect_types.end() && !(this->*(it->second))(iss)) {
-      LogError("AllocateMemory", "Invalid format in line: " + line);
-      result_code = invalid_format;
-      break;
+  if (!model) {
+    model.emplace(file_path, options);
+    if (model->GetId() < 0) {
+      model.reset();
+    } else if (key) {
+      cache.Store(*key, *model);
     }
   }
+  // The cache holds the mesh as parsed, whatever the weld setting
+  if (model && options.weld_tolerance >= 0) {
+    model->WeldVertices(options.weld_tolerance, options.thread_count);
+  }
+  return model;
+}
 
-  if (result_code == success_code && !ValidateCounters()) {
-    result_code = invalid_format;
-    LogError("AllocateMemory", invalid_format);
+WeldStats WireframeObject::WeldVertices(float tolerance,
+                                        unsigned thread_count) {
+  auto start = std::chrono::steady_clock::now();
+  WeldStats stats;
+  stats.vertices_before = vertices_.size();
+  float epsilon = 0.0f;
+  if (tolerance > 0 && !bounds_.IsEmpty()) {
+    epsilon = tolerance * std::hypot(bounds_.max.x - bounds_.min.x,
+                                     bounds_.max.y - bounds_.min.y,
+                                     bounds_.max.z - bounds_.min.z);
   }
 
-  if (result_code == success_code) {
-    try {
-      vertices_.reserve(count_.v);
-      textures_.reserve(count_.vt);
-      normals_.reserve(count_.vn);
-      faces_.reserve(count_.f);
-    } catch (const std::bad_alloc &) {
-      result_code = memory_error;
+  ArenaVector<Coordinate> welded;
+  std::vector<std::uint64_t> remap;
+  WeldPositions(vertices_, epsilon, thread_count, welded, remap);
+  if (welded.size() < vertices_.size()) {
+    RemapIndices(faces_, remap, thread_count);
+    RemapIndices(wide_faces_, remap, thread_count);
+    vertices_ = std::move(welded);
+    count_.v = vertices_.size();
+    ComputeBounds();
+    // Welded faces share edges they didn't share before
+    BuildEdges(thread_count);
+  }
+
+  stats.vertices_after = vertices_.size();
+  stats.milliseconds = std::chrono::duration<double, std::milli>(
+                           std::chrono::steady_clock::now() - start)
+                           .count();
+  weld_stats_ = stats;
+  return stats;
+}
+
+ErrorCode WireframeObject::ParseBuffer(std::string_view buffer,
+                                       const LoadOptions &options) {
+  unsigned thread_count = ResolveThreadCount(options.thread_count);
+  std::size_t chunk_count =
+      std::min<std::size_t>(thread_count * kChunksPerThread,
+                            buffer.size() / kMinChunkBytes);
+  bool is_streaming = options.stream != nullptr;
+  if (thread_count > 1 && chunk_count > 1) {
+    ErrorCode result_code = ParseChunks(SplitAtLines(buffer, chunk_count),
+                                        thread_count, options);
+    // Cancelling and running out of budget don't depend on the line
+    if (result_code == success_code || result_code == load_cancelled ||
+        result_code == memory_error) {
+      return FinishParsing(result_code, thread_count);
     }
+    // Some chunk failed: re-parse serially to report the exact line. The
+    // valid prefix was already streamed, so this pass doesn't publish.
+    Clear();
+    if (options.progress != nullptr) options.progress->Rewind();
+    is_streaming = false;
   }
 
-  file.clear();
-  file.seekg(0, std::ios::beg);
-  return result_code;
+  // The serial chunk becomes the mesh, it needs the arena only to keep it
+  std::shared_ptr<Arena> arena =
+      options.contiguous_mesh ? MakeLoadArena(options) : nullptr;
+  ObjChunk chunk;
+  ConfigureChunk(chunk, arena.get(), options);
+  if (is_streaming) chunk.SetStream(options.stream);
+  if (options.reserve_by_file_size) chunk.ReserveByFileSize(buffer.size());
+  ErrorCode result_code = chunk.Parse(buffer);
+  if (result_code == success_code) {
+    TakeChunk(chunk, thread_count);
+    arena_ = arena;
+  }
+  return FinishParsing(result_code, thread_count);
 }
 
-void WireframeObject::GetValues(std::ifstream &file) noexcept {
-  const std::map<std::string, ParseFunction> parse_types = {
-      {"v", &WireframeObject::ParseVertex},
-      {"vt", &WireframeObject::ParseTextureCoordinate},
-      {"vn", &WireframeObject::ParseNormal},
-      {"f", &WireframeObject::ParseFace}};
+ErrorCode WireframeObject::ParseChunks(
+    const std::vector<std::string_view> &pieces, unsigned thread_count,
+    const LoadOptions &options) {
+  // Chunks are scratch data, merged into the arena or onto the heap
+  std::shared_ptr<Arena> arena = MakeLoadArena(options);
+  std::vector<ObjChunk> chunks(pieces.size(), ObjChunk(true));
+  std::vector<ErrorCode> results(pieces.size(), success_code);
+  // Streaming state: chunks are published whole and in file order
+  std::mutex publish_mutex;
+  std::vector<bool> is_parsed(pieces.size(), false);
+  std::size_t next_to_publish = 0;
+  bool is_publish_failed = false;
+  Counter published;
+  // Every chunk gets a share of the budget proportional to its size
+  std::uint64_t memory_budget = ResolveMemoryBudget(options.memory_budget);
+  std::uint64_t total_bytes = 0;
+  for (std::string_view piece : pieces) total_bytes += piece.size();
+
+  ParallelFor(pieces.size(), thread_count, [&](std::size_t i) {
+    chunks[i].SetArena(arena.get());
+    chunks[i].SetProgress(options.progress);
+    chunks[i].SetTriangulation(options.triangulation);
+    if (memory_budget != 0) {
+      chunks[i].SetMemoryBudget(std::max<std::uint64_t>(
+          1, static_cast<std::uint64_t>(static_cast<double>(memory_budget) *
+                                        pieces[i].size() / total_bytes)));
+    }
+    if (options.reserve_by_file_size) {
+      chunks[i].ReserveByFileSize(pieces[i].size());
+    }
+    results[i] = chunks[i].Parse(pieces[i]);
+    if (options.stream == nullptr) return;
+
+    std::lock_guard<std::mutex> lock(publish_mutex);
+    is_parsed[i] = true;
+    while (next_to_publish < chunks.size() && is_parsed[next_to_publish]) {
+      ObjChunk &chunk = chunks[next_to_publish];
+      if (results[next_to_publish] != success_code ||
+          !chunk.ReferencesFit(published) ||
+          chunk.GetIndexWidth() != kIndex32) {
+        // Nothing after an invalid or widened chunk may reach the viewer
+        next_to_publish = chunks.size();
+        break;
+      }
+      try {
+        options.stream->Publish(chunk.vertices_, chunk.faces_);
+      } catch (const std::bad_alloc &) {
+        is_publish_failed = true;
+        next_to_publish = chunks.size();
+        break;
+      }
+      published += chunk.count_;
+      next_to_publish++;
+    }
+  });
 
-  std::string line;
+  // Faces use absolute indices: a chunk is valid once the records of all
+  // chunks before it cover every index it references
+  if (std::find(results.begin(), results.end(), load_cancelled) !=
+      results.end()) {
+    return load_cancelled;
+  }
+  if (is_publish_failed) {
+    LogError("ParseChunks", memory_error);
+    return memory_error;
+  }
+  std::uint64_t memory_usage = 0;
+  for (const ObjChunk &chunk : chunks) memory_usage += chunk.MemoryUsage();
+  // Merging holds the chunks and the merged arrays at the same time
+  if (std::find(results.begin(), results.end(), memory_error) !=
+          results.end() ||
+      (memory_budget != 0 && memory_usage * 2 > memory_budget)) {
+    LogError("ParseChunks", "Model exceeds the memory budget of " +
+                                std::to_string(memory_budget >> 20) + " MB");
+    return memory_error;
+  }
+  Counter preceding;
+  for (std::size_t i = 0; i < chunks.size(); ++i) {
+    if (results[i] != success_code || !chunks[i].ReferencesFit(preceding)) {
+      return invalid_format;
+    }
+    preceding += chunks[i].count_;
+  }
 
-  while (std::getline(file, line)) {
-    if (line.empty() || line[0] == '#') continue;
+  try {
+    Arena *mesh_arena = options.contiguous_mesh ? arena.get() : nullptr;
+    MergeChunks(chunks, thread_count, mesh_arena);
+    if (mesh_arena != nullptr) arena_ = arena;
+  } catch (const std::bad_alloc &) {
+    return memory_error;
+  }
+  return success_code;
+}
 
-    std::istringstream iss(line);
-    std::string prefix;
-    iss >> prefix;
+ErrorCode WireframeObject::ParseStream(std::ifstream &file,
+                                       std::uintmax_t reserve_bytes,
+                                       const LoadOptions &options) {
+  // A stream can't be split between threads, it is always parsed serially
+  std::shared_ptr<Arena> arena =
+      options.contiguous_mesh ? MakeLoadArena(options) : nullptr;
+  ObjChunk chunk;
+  ConfigureChunk(chunk, arena.get(), options);
+  chunk.SetStream(options.stream);
+  chunk.ReserveByFileSize(reserve_bytes);
 
-    auto it = parse_types.find(prefix);
-    if (it != parse_types.end()) (this->*(it->second))(iss);
+  ErrorCode result_code = success_code;
+  std::string line;
+  std::uint64_t lines = 0, unreported_bytes = 0;
+  try {
+    while (result_code == success_code && std::getline(file, line)) {
+      result_code = chunk.ParseLine(line);
+      unreported_bytes += line.size() + 1;
+      if (++lines % kProgressLines == 0 && result_code == success_code) {
+        result_code = chunk.CheckPoint(unreported_bytes);
+        unreported_bytes = 0;
+      }
+    }
+    if (result_code == success_code) {
+      result_code = chunk.CheckPoint(unreported_bytes);
+    }
+  } catch (const std::bad_alloc &) {
+    LogError("ParseStream", memory_error);
+    result_code = memory_error;
+  }
+  if (result_code == success_code) {
+    TakeChunk(chunk, ResolveThreadCount(options.thread_count));
+    arena_ = arena;
   }
+  return FinishParsing(result_code, options.thread_count);
 }
 
-void WireframeObject::AssignName(const std::string file_path) noexcept {
-  size_t last_slash = file_path.find_last_of("/\\");
-  if (last_slash != std::string::npos) {
-    name_ = file_path.substr(last_slash + 1);
-  } else {
-    name_ = file_path;
+ErrorCode WireframeObject::ParseBinary(const std::string &file_path,
+                                       const MeshFormat &format,
+                                       const LoadOptions &options) {
+  // Binary layouts are read in bulk straight from the mapping
+  MappedFile mapped_file(file_path);
+  if (!mapped_file.IsMapped()) {
+    LogError("ParseBinary",
+             std::string(format.name) + " files can only be read from disk");
+    return file_not_found;
+  }
+  if (options.progress != nullptr) {
+    options.progress->SetTotalBytes(mapped_file.GetView().size());
+  }
+  std::shared_ptr<Arena> arena =
+      options.contiguous_mesh ? MakeLoadArena(options) : nullptr;
+  ObjChunk chunk;
+  ConfigureChunk(chunk, arena.get(), options);
+  chunk.SetStream(options.stream);
+  unsigned thread_count = ResolveThreadCount(options.thread_count);
+
+  ErrorCode result_code = success_code;
+  try {
+    result_code = format.load(mapped_file.GetView(), chunk, thread_count);
+  } catch (const std::bad_alloc &) {
+    LogError("ParseBinary", memory_error);
+    result_code = memory_error;
+  }
+  if (result_code == success_code) {
+    TakeChunk(chunk, thread_count);
+    arena_ = arena;
   }
+  return FinishParsing(result_code, thread_count);
 }
 
-bool WireframeObject::CheckVertex(std::istringstream &iss) {
-  Coordinate vertex;
-  if (!(iss >> vertex.x >> vertex.y >> vertex.z)) return false;
-  if (!vertex.IsValid()) return false;
-  count_.v++;
-  return true;
+ErrorCode WireframeObject::ParseGzip(GzipReader &reader,
+                                     const LoadOptions &options) {
+  // Blocks arrive in file order, one serial chunk takes them all
+  std::shared_ptr<Arena> arena =
+      options.contiguous_mesh ? MakeLoadArena(options) : nullptr;
+  ObjChunk chunk;
+  ConfigureChunk(chunk, arena.get(), options);
+  chunk.SetStream(options.stream);
+  if (options.reserve_by_file_size) {
+    chunk.ReserveByFileSize(reader.GetSizeHint());
+  }
+
+  ErrorCode result_code = success_code;
+  std::string block;
+  while (result_code == success_code && reader.Next(block)) {
+    result_code = chunk.Parse(block);
+  }
+  if (result_code == success_code) {
+    result_code = reader.GetResult();
+    if (result_code != success_code) LogError("ParseGzip", result_code);
+  }
+  if (result_code == success_code) {
+    TakeChunk(chunk, ResolveThreadCount(options.thread_count));
+    arena_ = arena;
+  }
+  return FinishParsing(result_code, options.thread_count);
 }
 
-bool WireframeObject::CheckTexture(std::istringstream &iss) {
-  TextureCoordinate texture;
-  if (!(iss >> texture.u >> texture.v)) return false;
-  if (!texture.IsValid()) return false;
-  count_.vt++;
-  return true;
+ErrorCode WireframeObject::FinishParsing(ErrorCode result_code,
+                                         unsigned thread_count) {
+  if (result_code == success_code && !ValidateCounters()) {
+    result_code = invalid_format;
+    LogError("FinishParsing", invalid_format);
+  }
+  if (result_code == success_code) {
+    ComputeBounds();
+    try {
+      BuildEdges(thread_count);
+    } catch (const std::bad_alloc &) {
+      result_code = memory_error;
+      LogError("FinishParsing", memory_error);
+    }
+  }
+  return result_code;
 }
 
-bool WireframeObject::CheckNormal(std::istringstream &iss) {
-  Coordinate normal;
-  if (!(iss >> normal.x >> normal.y >> normal.z)) return false;
-  if (!normal.IsValid()) return false;
-  // Normal vector components should be in [-1, 1]
-  if (std::abs(normal.x) > 1.01f || std::abs(normal.y) > 1.01f ||
-      std::abs(normal.z) > 1.01f) {
-    return false;
+void WireframeObject::BuildEdges(unsigned thread_count) {
+  // Meshes with 64-bit indices are drawn as points, they need no edges
+  if (index_width_ != kIndex32 || faces_.empty()) {
+    edges_.clear();
+    return;
   }
-  count_.vn++;
-  return true;
+  ArenaVector<Edge> edges{ArenaAllocator<Edge>(arena_.get())};
+  BuildEdgeList(faces_, face_edges_, vertices_.size(), thread_count, edges);
+  edges_ = std::move(edges);
 }
 
-bool WireframeObject::CheckFace(std::istringstream &iss) {
-  // Face face;
-  std::string vertex_data;
-  for (int i = 0; i < 3; i++) {
-    if (!(iss >> vertex_data)) {
-      return false;
-    }
-    size_t slash_count =
-        std::count(vertex_data.begin(), vertex_data.end(), '/');
-
-    int v_idx = 0, vt_idx = 0, vn_idx = 0;
-    if (slash_count == 2) {
-      if (sscanf(vertex_data.c_str(), "%d/%d/%d", &v_idx, &vt_idx, &vn_idx) !=
-          3) {
-        return false;
-      }
-      if (v_idx < 1 || v_idx > count_.v || vt_idx < 1 || vt_idx > count_.vt ||
-          vn_idx < 1 || vn_idx > count_.vn) {
-        return false;
-      }
-    } else if (slash_count == 1) {
-      if (sscanf(vertex_data.c_str(), "%d/%d", &v_idx, &vt_idx) != 2) {
-        return false;
-      }
-      if (v_idx < 1 || v_idx > count_.v || vt_idx < 1 || vt_idx > count_.vt) {
-        return false;
-      }
-    } else if (slash_count == 0) {
-      if (sscanf(vertex_data.c_str(), "%d", &v_idx) != 1) {
-        return false;
-      }
-      if (v_idx < 1 || v_idx > count_.v) {
-        return false;
-      }
+void WireframeObject::TakeChunk(ObjChunk &chunk, unsigned thread_count) {
+  if (!chunk.polygons_.empty()) {
+    if (chunk.GetIndexWidth() == kIndex32) {
+      EarClipPolygons<Face>(chunk.vertices_, chunk.polygons_, chunk.faces_,
+                            chunk.texture_faces_, chunk.normal_faces_,
+                            chunk.face_edges_, thread_count);
     } else {
-      return false;
+      EarClipPolygons<WideFace>(
+          chunk.vertices_, chunk.polygons_, chunk.wide_faces_,
+          chunk.wide_texture_faces_, chunk.wide_normal_faces_,
+          chunk.face_edges_, thread_count);
     }
   }
-  count_.f++;
-  return true;
+  vertices_ = std::move(chunk.vertices_);
+  textures_ = std::move(chunk.textures_);
+  normals_ = std::move(chunk.normals_);
+  faces_ = std::move(chunk.faces_);
+  texture_faces_ = std::move(chunk.texture_faces_);
+  normal_faces_ = std::move(chunk.normal_faces_);
+  wide_faces_ = std::move(chunk.wide_faces_);
+  wide_texture_faces_ = std::move(chunk.wide_texture_faces_);
+  wide_normal_faces_ = std::move(chunk.wide_normal_faces_);
+  index_width_ = chunk.GetIndexWidth();
+  face_edges_ = std::move(chunk.face_edges_);
+  count_ = chunk.count_;
+}
+
+void WireframeObject::MergeChunks(std::vector<ObjChunk> &chunks,
+                                  unsigned thread_count, Arena *mesh_arena) {
+  // Prefix offsets: where the records of every chunk start in the result
+  std::vector<Counter> offsets(chunks.size());
+  bool is_wide = false;
+  for (std::size_t i = 0; i < chunks.size(); ++i) {
+    offsets[i] = count_;
+    count_ += chunks[i].count_;
+    is_wide = is_wide || chunks[i].GetIndexWidth() == kIndex64;
+  }
+  ArenaVector<Coordinate> vertices(count_.v,
+                                   ArenaAllocator<Coordinate>(mesh_arena));
+  ArenaVector<TextureCoordinate> textures(
+      count_.vt, ArenaAllocator<TextureCoordinate>(mesh_arena));
+  ArenaVector<Coordinate> normals(count_.vn,
+                                  ArenaAllocator<Coordinate>(mesh_arena));
+
+  ParallelFor(chunks.size(), thread_count, [&](std::size_t i) {
+    ObjChunk &chunk = chunks[i];
+    std::copy(chunk.vertices_.begin(), chunk.vertices_.end(),
+              vertices.begin() + offsets[i].v);
+    std::copy(chunk.textures_.begin(), chunk.textures_.end(),
+              textures.begin() + offsets[i].vt);
+    std::copy(chunk.normals_.begin(), chunk.normals_.end(),
+              normals.begin() + offsets[i].vn);
+    ReleaseStorage(chunk.vertices_);
+    ReleaseStorage(chunk.textures_);
+    ReleaseStorage(chunk.normals_);
+    // One chunk past the 32-bit range makes the whole mesh wide
+    if (is_wide) chunk.Widen();
+  });
+
+  // Polygons to ear-clip, numbered like the merged faces
+  std::vector<PolygonRun> polygons;
+  for (std::size_t i = 0; i < chunks.size(); ++i) {
+    for (PolygonRun polygon : chunks[i].polygons_) {
+      polygon.first_face += offsets[i].f;
+      polygons.push_back(polygon);
+    }
+  }
+  ArenaVector<FaceEdgeMask> face_edges =
+      MergeColumn(chunks, offsets, count_.f, thread_count,
+                  &ObjChunk::face_edges_, kAllFaceEdges, mesh_arena);
+
+  if (is_wide) {
+    FaceColumns<WideFace> merged = MergeFaceColumns(
+        chunks, offsets, count_.f, thread_count, &ObjChunk::wide_faces_,
+        &ObjChunk::wide_texture_faces_, &ObjChunk::wide_normal_faces_,
+        mesh_arena);
+    EarClipPolygons<WideFace>(vertices, polygons, merged.faces,
+                              merged.texture_faces, merged.normal_faces,
+                              face_edges, thread_count);
+    wide_faces_ = std::move(merged.faces);
+    wide_texture_faces_ = std::move(merged.texture_faces);
+    wide_normal_faces_ = std::move(merged.normal_faces);
+    index_width_ = kIndex64;
+  } else {
+    FaceColumns<Face> merged = MergeFaceColumns(
+        chunks, offsets, count_.f, thread_count, &ObjChunk::faces_,
+        &ObjChunk::texture_faces_, &ObjChunk::normal_faces_, mesh_arena);
+    EarClipPolygons<Face>(vertices, polygons, merged.faces,
+                          merged.texture_faces, merged.normal_faces,
+                          face_edges, thread_count);
+    faces_ = std::move(merged.faces);
+    texture_faces_ = std::move(merged.texture_faces);
+    normal_faces_ = std::move(merged.normal_faces);
+    index_width_ = kIndex32;
+  }
+  vertices_ = std::move(vertices);
+  textures_ = std::move(textures);
+  normals_ = std::move(normals);
+  face_edges_ = std::move(face_edges);
 }
 
-void WireframeObject::ParseVertex(std::istringstream &iss) {
-  Coordinate vertex;
-  iss >> vertex.x >> vertex.y >> vertex.z;
-  vertices_.push_back(vertex);
+std::vector<std::string_view> WireframeObject::SplitAtLines(
+    std::string_view buffer, std::size_t count) {
+  std::vector<std::string_view> pieces;
+  std::size_t begin = 0;
+  for (std::size_t i = 1; i <= count && begin < buffer.size(); ++i) {
+    std::size_t end = buffer.size() * i / count;
+    if (end < begin) end = begin;
+    // Move the cut past the end of the line it falls into
+    end = i == count ? buffer.size() : buffer.find('\n', end);
+    end = end == std::string_view::npos ? buffer.size() : end + 1;
+    pieces.push_back(buffer.substr(begin, end - begin));
+    begin = end;
+  }
+  return pieces;
 }
 
-void WireframeObject::ParseTextureCoordinate(std::istringstream &iss) {
-  TextureCoordinate texture;
-  iss >> texture.u >> texture.v;
-  textures_.push_back(texture);
+void WireframeObject::ComputeBounds() {
+  bounds_ = Bounds();
+  if (vertices_.empty()) return;
+  bounds_.min = bounds_.max = vertices_[0];
+  for (const Coordinate &vertex : vertices_) {
+    bounds_.min.x = std::min(bounds_.min.x, vertex.x);
+    bounds_.min.y = std::min(bounds_.min.y, vertex.y);
+    bounds_.min.z = std::min(bounds_.min.z, vertex.z);
+    bounds_.max.x = std::max(bounds_.max.x, vertex.x);
+    bounds_.max.y = std::max(bounds_.max.y, vertex.y);
+    bounds_.max.z = std::max(bounds_.max.z, vertex.z);
+  }
 }
 
-void WireframeObject::ParseNormal(std::istringstream &iss) {
-  Coordinate normal;
-  iss >> normal.x >> normal.y >> normal.z;
-  normals_.push_back(normal);
+void WireframeObject::Clear() noexcept {
+  vertices_.clear();
+  textures_.clear();
+  normals_.clear();
+  faces_.clear();
+  texture_faces_.clear();
+  normal_faces_.clear();
+  wide_faces_.clear();
+  wide_texture_faces_.clear();
+  wide_normal_faces_.clear();
+  index_width_ = kIndex32;
+  face_edges_.clear();
+  edges_.clear();
+  arena_.reset();
+  bounds_ = Bounds();
+  count_ = Counter();
 }
 
-void WireframeObject::ParseFace(std::istringstream &iss) {
-  Face face;
-  std::string vertex_data;
-
-  for (int i = 0; i < 3; i++) {
-    iss >> vertex_data;
-    size_t slash_count =
-        std::count(vertex_data.begin(), vertex_data.end(), '/');
-
-    int v_idx = 0, vt_idx = 0, vn_idx = 0;
-    if (slash_count == 2) {
-      // v/vt/vn format
-      sscanf(vertex_data.c_str(), "%d/%d/%d", &v_idx, &vt_idx, &vn_idx);
-      face.position[i] = &vertices_[v_idx - 1];
-      face.texture[i] = &textures_[vt_idx - 1];
-      face.normal = &normals_[vn_idx - 1];
-    } else if (slash_count == 1) {
-      // v/vt format
-      sscanf(vertex_data.c_str(), "%d/%d", &v_idx, &vt_idx);
-      face.position[i] = &vertices_[v_idx - 1];
-      face.texture[i] = &textures_[vt_idx - 1];
-      face.normal = nullptr;
-    } else if (slash_count == 0) {
-      // v format
-      sscanf(vertex_data.c_str(), "%d", &v_idx);
-      face.position[i] = &vertices_[v_idx - 1];
-      face.texture[i] = nullptr;
-      face.normal = nullptr;
-    }
+void WireframeObject::AssignName(const std::string file_path) noexcept {
+  size_t last_slash = file_path.find_last_of("/\\");
+  if (last_slash != std::string::npos) {
+    name_ = file_path.substr(last_slash + 1);
+  } else {
+    name_ = file_path;
   }
-
-  faces_.push_back(face);
 }
 
 bool WireframeObject::ValidateCounters() const {
-  if (count_.v <= 0 || count_.v > kMaxVertices) {
+  // Size is limited by the memory budget while parsing, not by a constant
+  if (count_.v == 0) {
     LogError("ValidateCounters", "Invalid vertex count_");
     return false;
   }
-  if (count_.f <= 0 || count_.f > kMaxFaces) {
-    LogError("ValidateCounters", "Invalid face count_");
-    return false;
-  }
+  // A file without faces is a point cloud
   return true;
 }
 }  // namespace s21
@@ -1,45 +1,88 @@
 #ifndef MODEL_PARSER_H
 #define MODEL_PARSER_H
 
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <span>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "model/arena.h"
 #include "model/errors.h"
+#include "model/gzip_reader.h"
+#include "model/load_progress.h"
+#include "model/mapped_file.h"
+#include "model/mesh_array.h"
+#include "model/mesh_format.h"
+#include "model/mesh_stream.h"
+#include "model/mesh_types.h"
+#include "model/obj_chunk.h"
+#include "model/parallel.h"
 
 namespace s21 {
-const int kMaxVertices = 1500000;
-const int kMaxFaces = 5000000;
+// Smallest piece of a file worth handing to its own thread
+const std::size_t kMinChunkBytes = 1 << 20;
+// More chunks than threads evens out chunks that parse slower than others
+const unsigned kChunksPerThread = 4;
 
-struct Coordinate {
-  float x{0.0f}, y{0.0f}, z{0.0f};
-  bool IsValid() const {
-    return !std::isnan(x) && !std::isnan(y) && !std::isnan(z);
-  }
-};
-struct TextureCoordinate {
-  float u{0.0f}, v{0.0f};
-  bool IsValid() const {
-    return !std::isnan(u) && !std::isnan(v) && u >= -0.01f && u <= 1.01f &&
-           v >= -0.01f && v <= 1.01f;
-  }
-};
-struct Face {
-  Coordinate *position[3];
-  TextureCoordinate *texture[3];
-  Coordinate *normal;
+// gzip files are inflated on a separate thread in either mode
+typedef enum {
+  kLoadMapped = 0,  // mmap regular files, stream everything else
+  kLoadStream,      // always read line by line through std::ifstream
+} LoadModeT;
+
+struct LoadOptions {
+  LoadModeT mode = kLoadMapped;
+  bool reserve_by_file_size = true;
+  // Threads parsing a mapped file: 0 = one per hardware thread, 1 = serial
+  unsigned thread_count = 0;
+  // WireframeObject::Load serves and refreshes the binary mesh cache
+  bool use_cache = false;
+  // Where cache entries live, empty = MeshCache::DefaultDirectory()
+  std::string cache_dir;
+  // Receives progress updates and can cancel the load, may be shared with
+  // another thread; nullptr = no reporting
+  LoadProgress *progress = nullptr;
+  // Receives the parsed prefix of the mesh while loading, nullptr = none
+  MeshStream *stream = nullptr;
+  // Bytes the parsed arrays may take, 0 = three quarters of physical memory
+  std::uint64_t memory_budget = 0;
+  // How faces with more than three corners are cut into triangles
+  TriangulationT triangulation = kTriangulateFan;
+  // Keep the finished mesh in the arena the file was parsed into: one
+  // contiguous, huge-page aligned block instead of an allocation per array
+  bool contiguous_mesh = true;
+  // WireframeObject::Load welds vertices closer than this fraction of the
+  // bounding box diagonal: 0 = identical positions only, negative = never
+  float weld_tolerance = -1.0f;
 };
-struct Counter {
-  int v = 0, vt = 0, vn = 0, f = 0;
+
+// What WireframeObject::WeldVertices() did
+struct WeldStats {
+  std::size_t vertices_before = 0;
+  std::size_t vertices_after = 0;
+  double milliseconds = 0.0;
 };
 
+// Address space reserved for the arena of one load, in memory budgets, and
+// at least kMinArenaBytes so that a small budget is caught by the budget
+// check rather than by an exhausted arena
+const std::uint64_t kArenaBudgetFactor = 4;
+const std::uint64_t kMinArenaBytes = std::uint64_t{1} << 30;
+
+std::uint64_t ResolveMemoryBudget(std::uint64_t memory_budget);
+
 /**
  * @class WireframeObject
  * @brief A class representing a 3D wireframe object loaded from an OBJ file
@@ -48,58 +91,151 @@ struct Counter {
  * - Vertices (3D coordinates)
  * - Texture coordinates
  * - Normal vectors
- * - Faces (triangles defined by vertex indices)
+ * - Faces (triangles defined by vertex indices, with optional texture and
+ *   normal indices per corner). Indices are 32-bit whenever every record
+ *   fits, the Wide* arrays with 64-bit indices are used otherwise. Polygons
+ *   are triangulated while parsing; GetFaceEdges() tells which triangle
+ *   edges belong to the original polygon outlines.
+ * - Edges and the bounding box of the mesh. GetEdges() lists every edge
+ *   of the polygon outlines once however many faces share it (see
+ *   BuildEdgeList()), for drawing the wireframe as GL_LINES.
+ *
+ * Parsing draws its arrays from one Arena per load instead of the heap, so
+ * a load costs a fixed number of allocations whatever the file size. With
+ * LoadOptions::contiguous_mesh the finished mesh stays in that block.
+ *
+ * gzip-compressed files are recognised by their header and parsed while
+ * another thread inflates them, without a decompressed copy on disk. Binary
+ * STL and PLY files (see GetMeshFormats()) are read in bulk into the same
+ * arrays; glTF models are built by GltfLoader, which can leave their buffers
+ * mapped.
+ *
+ * Files made of vertices only load as point clouds: no face arrays are
+ * reserved for them and the viewer draws the positions as points.
  *
  * The class provides functionality to:
- * - Load OBJ files
+ * - Load OBJ files, optionally through the binary mesh cache
  * - Store geometric and texture data
  * - Manage object identification
  * - Access model components (vertices, faces, etc.)
  */
 class WireframeObject {
  public:
-  // Rule of three
-  WireframeObject(const std::string file_path);
+  // Rule of five
+  WireframeObject(const std::string file_path,
+                  const LoadOptions &options = LoadOptions());
   ~WireframeObject();
   WireframeObject(const WireframeObject &other);
   WireframeObject &operator=(const WireframeObject &other);
+  WireframeObject(WireframeObject &&other) noexcept;
+  WireframeObject &operator=(WireframeObject &&other) noexcept;
+
+  // Parses the file once; std::nullopt when it could not be loaded (the
+  // reason is in the error log). Move the result into its final owner.
+  static std::optional<WireframeObject> Load(
+      const std::string &file_path, const LoadOptions &options = LoadOptions());
 
   // Member functions
   void SetName(const std::string &new_name) { name_ = new_name; }
   std::string GetName() const { return name_; }
   int GetId() const { return id_; }
   static void ResetIdCounter() { next_id_ = 0; }
-  const auto GetVertices() const { return vertices_; }
-  const auto GetFaces() const { return faces_; }
+  // Views into the model's own storage: no copies, valid while the model
+  // lives and is not reloaded
+  std::span<const Coordinate> GetVertices() const { return vertices_; }
+  std::span<const Face> GetFaces() const { return faces_; }
+  std::span<const TextureCoordinate> GetTextures() const { return textures_; }
+  std::span<const Coordinate> GetNormals() const { return normals_; }
+  // Per-face texture/normal indices, empty when no face references any
+  std::span<const Face> GetTextureFaces() const { return texture_faces_; }
+  std::span<const Face> GetNormalFaces() const { return normal_faces_; }
+  IndexWidthT GetIndexWidth() const { return index_width_; }
+  // Faces of a kIndex64 mesh, empty for kIndex32 ones
+  std::span<const WideFace> GetWideFaces() const { return wide_faces_; }
+  std::span<const WideFace> GetWideTextureFaces() const {
+    return wide_texture_faces_;
+  }
+  std::span<const WideFace> GetWideNormalFaces() const {
+    return wide_normal_faces_;
+  }
+  // Outline mask per face, empty when the file had triangles only
+  std::span<const FaceEdgeMask> GetFaceEdges() const { return face_edges_; }
+  // Unique outline edges, empty for point clouds and 64-bit meshes
+  std::span<const Edge> GetEdges() const { return edges_; }
+  const Bounds &GetBounds() const { return bounds_; }
+  std::size_t GetVertexCount() const { return vertices_.size(); }
+  std::size_t GetFaceCount() const {
+    return index_width_ == kIndex32 ? faces_.size() : wide_faces_.size();
+  }
+  bool IsPointCloud() const {
+    return GetFaceCount() == 0 && !vertices_.empty();
+  }
+  std::size_t GetTextureCount() const { return textures_.size(); }
+  std::size_t GetNormalCount() const { return normals_.size(); }
 
   void AssignName(const std::string file_path) noexcept;
+  // Merges vertices within tolerance * the bounding box diagonal of each
+  // other (see WeldPositions()), points the faces at the survivors and
+  // lists the edges again. Faces keep their count even where two corners
+  // merged.
+  WeldStats WeldVertices(float tolerance, unsigned thread_count = 0);
+  // Set once WeldVertices() ran on this mesh
+  const std::optional<WeldStats> &GetWeldStats() const { return weld_stats_; }
+  // False once WeldVertices() merged vertices: the arrays were renumbered
+  // and no longer start with the records published to LoadOptions::stream
+  bool KeepsStreamedPrefix() const {
+    return !weld_stats_ ||
+           weld_stats_->vertices_after == weld_stats_->vertices_before;
+  }
 
  protected:
-  ErrorCode AllocateMemory(std::ifstream &file);
-  void GetValues(std::ifstream &file) noexcept;
+  ErrorCode ParseBuffer(std::string_view buffer, const LoadOptions &options);
+  ErrorCode ParseChunks(const std::vector<std::string_view> &pieces,
+                        unsigned thread_count, const LoadOptions &options);
+  ErrorCode ParseStream(std::ifstream &file, std::uintmax_t reserve_bytes,
+                        const LoadOptions &options);
+  ErrorCode ParseGzip(GzipReader &reader, const LoadOptions &options);
+  ErrorCode ParseBinary(const std::string &file_path, const MeshFormat &format,
+                        const LoadOptions &options);
+  ErrorCode FinishParsing(ErrorCode result_code, unsigned thread_count);
+  void TakeChunk(ObjChunk &chunk, unsigned thread_count);
+  void MergeChunks(std::vector<ObjChunk> &chunks, unsigned thread_count,
+                   Arena *mesh_arena);
+  void ComputeBounds();
+  void BuildEdges(unsigned thread_count);
+  void Clear() noexcept;
 
   // helper functions
-  using InputFunction = bool (WireframeObject::*)(std::istringstream &);
-  using ParseFunction = void (WireframeObject::*)(std::istringstream &);
-  bool CheckVertex(std::istringstream &iss);
-  bool CheckTexture(std::istringstream &iss);
-  bool CheckNormal(std::istringstream &iss);
-  bool CheckFace(std::istringstream &iss);
-  void ParseVertex(std::istringstream &iss);
-  void ParseTextureCoordinate(std::istringstream &iss);
-  void ParseNormal(std::istringstream &iss);
-  void ParseFace(std::istringstream &iss);
+  static std::vector<std::string_view> SplitAtLines(std::string_view buffer,
+                                                    std::size_t count);
   bool ValidateCounters() const;
 
  protected:
   static int next_id_;
   std::string name_;
-  std::vector<Coordinate> vertices_;
-  std::vector<Face> faces_;
-  std::vector<TextureCoordinate> textures_;
-  std::vector<Coordinate> normals_;
+  // Holds the arrays of a contiguous mesh, declared first to outlive them
+  std::shared_ptr<Arena> arena_;
+  MeshArray<Coordinate> vertices_;
+  MeshArray<Face> faces_;
+  MeshArray<TextureCoordinate> textures_;
+  MeshArray<Coordinate> normals_;
+  MeshArray<Face> texture_faces_;
+  MeshArray<Face> normal_faces_;
+  MeshArray<WideFace> wide_faces_;
+  MeshArray<WideFace> wide_texture_faces_;
+  MeshArray<WideFace> wide_normal_faces_;
+  IndexWidthT index_width_ = kIndex32;
+  MeshArray<FaceEdgeMask> face_edges_;
+  MeshArray<Edge> edges_;
+  Bounds bounds_;
   int id_ = -1;
   Counter count_;
+  std::optional<WeldStats> weld_stats_;
+
+ private:
+  WireframeObject() = default;
+  friend class MeshCache;
+  friend class GltfLoader;
 };  // class WireframeObject
 }  // namespace s21
 
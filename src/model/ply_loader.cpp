@@ -0,0 +1,414 @@
+#include "model/ply_loader.h"
+
+#include <bit>
+#include <charconv>
+#include <cstring>
+#include <initializer_list>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace s21 {
+namespace {
+// Values are copied as they are stored: little-endian
+static_assert(std::endian::native == std::endian::little);
+
+typedef enum {
+  kPlyInt8 = 0,
+  kPlyUint8,
+  kPlyInt16,
+  kPlyUint16,
+  kPlyInt32,
+  kPlyUint32,
+  kPlyFloat32,
+  kPlyFloat64,
+} PlyTypeT;
+
+const std::size_t kPlyTypeBytes[] = {1, 1, 2, 2, 4, 4, 4, 8};
+
+struct PlyProperty {
+  std::string name;
+  // Type of the items for a list
+  PlyTypeT type = kPlyFloat32;
+  bool is_list = false;
+  PlyTypeT count_type = kPlyUint8;
+};
+
+struct PlyElement {
+  std::string name;
+  std::uint64_t count = 0;
+  std::vector<PlyProperty> properties;
+};
+
+// Positions of the vertex attributes among the vertex properties, -1 when
+// the file doesn't have them
+struct VertexLayout {
+  int position[3] = {-1, -1, -1};
+  int normal[3] = {-1, -1, -1};
+  int texture[2] = {-1, -1};
+  bool HasNormals() const {
+    return normal[0] >= 0 && normal[1] >= 0 && normal[2] >= 0;
+  }
+  bool HasTextures() const { return texture[0] >= 0 && texture[1] >= 0; }
+};
+
+bool ParseType(std::string_view name, PlyTypeT &type) {
+  static const std::pair<std::string_view, PlyTypeT> kTypeNames[] = {
+      {"char", kPlyInt8},      {"int8", kPlyInt8},     {"uchar", kPlyUint8},
+      {"uint8", kPlyUint8},    {"short", kPlyInt16},   {"int16", kPlyInt16},
+      {"ushort", kPlyUint16},  {"uint16", kPlyUint16}, {"int", kPlyInt32},
+      {"int32", kPlyInt32},    {"uint", kPlyUint32},   {"uint32", kPlyUint32},
+      {"float", kPlyFloat32},  {"float32", kPlyFloat32},
+      {"double", kPlyFloat64}, {"float64", kPlyFloat64}};
+  for (const auto &[type_name, value] : kTypeNames) {
+    if (name == type_name) {
+      type = value;
+      return true;
+    }
+  }
+  return false;
+}
+
+std::vector<std::string_view> SplitWords(std::string_view line) {
+  std::vector<std::string_view> words;
+  std::size_t start = line.find_first_not_of(" \t");
+  while (start != std::string_view::npos) {
+    std::size_t end = line.find_first_of(" \t", start);
+    words.push_back(line.substr(start, end - start));
+    start = line.find_first_not_of(" \t", end);
+  }
+  return words;
+}
+
+int FindProperty(const PlyElement &element,
+                 std::initializer_list<std::string_view> names) {
+  for (std::size_t i = 0; i < element.properties.size(); ++i) {
+    for (std::string_view name : names) {
+      if (element.properties[i].name == name) return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
+// A record takes at least its scalars and the counts of its lists: counts
+// the body can't hold are refused before anything is reserved for them
+bool FitsBody(const std::vector<PlyElement> &elements, std::size_t body_bytes,
+              std::string &error) {
+  for (const PlyElement &element : elements) {
+    std::uint64_t record_bytes = 0;
+    for (const PlyProperty &property : element.properties) {
+      record_bytes +=
+          kPlyTypeBytes[property.is_list ? property.count_type : property.type];
+    }
+    if (element.count == 0) continue;
+    if (record_bytes == 0) {
+      error = "Element " + element.name + " has no properties";
+      return false;
+    }
+    if (element.count > body_bytes / record_bytes) {
+      error = "Element " + element.name + " declares " +
+              std::to_string(element.count) +
+              " records, more than the file holds";
+      return false;
+    }
+    body_bytes -= element.count * record_bytes;
+  }
+  return true;
+}
+
+// Reads the elements declared by the header; position ends up on the first
+// byte of the body
+bool ParseHeader(std::string_view data, std::vector<PlyElement> &elements,
+                 std::size_t &position, std::string &error) {
+  bool has_format = false;
+  std::size_t line_number = 0;
+  position = 0;
+  for (std::size_t end = data.find('\n'); end != std::string_view::npos;
+       end = data.find('\n', position)) {
+    std::string_view line = data.substr(position, end - position);
+    if (line.ends_with('\r')) line.remove_suffix(1);
+    position = end + 1;
+    std::vector<std::string_view> words = SplitWords(line);
+    if (line_number++ == 0) {
+      if (line == "ply") continue;
+      error = "File doesn't start with ply";
+      return false;
+    }
+    if (words.empty() || words[0] == "comment" || words[0] == "obj_info") {
+      continue;
+    }
+    if (words[0] == "end_header") {
+      if (!has_format) {
+        error = "Header has no format line";
+        return false;
+      }
+      return FitsBody(elements, data.size() - position, error);
+    }
+
+    if (words[0] == "format") {
+      if (words.size() < 2 || words[1] != "binary_little_endian") {
+        error = "Only binary little-endian PLY files are supported";
+        return false;
+      }
+      has_format = true;
+    } else if (words[0] == "element" && words.size() == 3) {
+      PlyElement element;
+      element.name = words[1];
+      auto [end_of_count, status] =
+          std::from_chars(words[2].data(), words[2].data() + words[2].size(),
+                          element.count);
+      if (status != std::errc() ||
+          end_of_count != words[2].data() + words[2].size()) {
+        error = "Invalid element count: " + std::string(line);
+        return false;
+      }
+      elements.push_back(element);
+    } else if (words[0] == "property" && !elements.empty()) {
+      PlyProperty property;
+      bool is_valid = false;
+      if (words.size() == 5 && words[1] == "list") {
+        property.is_list = true;
+        is_valid = ParseType(words[2], property.count_type) &&
+                   ParseType(words[3], property.type);
+        property.name = words[4];
+      } else if (words.size() == 3) {
+        is_valid = ParseType(words[1], property.type);
+        property.name = words[2];
+      }
+      if (!is_valid) {
+        error = "Unsupported property: " + std::string(line);
+        return false;
+      }
+      elements.back().properties.push_back(property);
+    } else {
+      error = "Unexpected header line: " + std::string(line);
+      return false;
+    }
+  }
+  error = "Header isn't closed by end_header";
+  return false;
+}
+
+/**
+ * @class PlyCursor
+ * @brief Bounds-checked reader over the body of a binary PLY file
+ */
+class PlyCursor {
+ public:
+  PlyCursor(std::string_view data, std::size_t position)
+      : data_(data), position_(position) {}
+
+  bool Read(PlyTypeT type, double &value) {
+    if (data_.size() - position_ < kPlyTypeBytes[type]) return false;
+    const char *bytes = data_.data() + position_;
+    position_ += kPlyTypeBytes[type];
+    switch (type) {
+      case kPlyInt8:
+        value = Load<std::int8_t>(bytes);
+        break;
+      case kPlyUint8:
+        value = Load<std::uint8_t>(bytes);
+        break;
+      case kPlyInt16:
+        value = Load<std::int16_t>(bytes);
+        break;
+      case kPlyUint16:
+        value = Load<std::uint16_t>(bytes);
+        break;
+      case kPlyInt32:
+        value = Load<std::int32_t>(bytes);
+        break;
+      case kPlyUint32:
+        value = Load<std::uint32_t>(bytes);
+        break;
+      case kPlyFloat32:
+        value = Load<float>(bytes);
+        break;
+      case kPlyFloat64:
+        value = Load<double>(bytes);
+        break;
+    }
+    return true;
+  }
+  // Reads the count of a list property; a scalar counts as a list of one
+  bool ReadCount(const PlyProperty &property, std::uint64_t &count) {
+    double value = 1.0;
+    if (property.is_list && !Read(property.count_type, value)) return false;
+    if (value < 0.0) return false;
+    count = static_cast<std::uint64_t>(value);
+    return true;
+  }
+  bool Skip(const PlyProperty &property) {
+    std::uint64_t count = 0;
+    if (!ReadCount(property, count)) return false;
+    std::uint64_t size = kPlyTypeBytes[property.type];
+    if ((data_.size() - position_) / size < count) return false;
+    position_ += count * size;
+    return true;
+  }
+  std::size_t GetPosition() const { return position_; }
+
+ private:
+  template <typename T>
+  static T Load(const char *bytes) {
+    T value;
+    std::memcpy(&value, bytes, sizeof(T));
+    return value;
+  }
+
+  std::string_view data_;
+  std::size_t position_;
+};  // class PlyCursor
+
+bool ReadVertex(PlyCursor &cursor, const PlyElement &element,
+                const VertexLayout &layout, std::vector<double> &values,
+                ObjChunk &chunk) {
+  for (std::size_t i = 0; i < element.properties.size(); ++i) {
+    const PlyProperty &property = element.properties[i];
+    bool is_read = property.is_list ? cursor.Skip(property)
+                                    : cursor.Read(property.type, values[i]);
+    if (!is_read) return false;
+  }
+  auto value = [&values](int i) { return static_cast<float>(values[i]); };
+  Coordinate vertex{value(layout.position[0]), value(layout.position[1]),
+                    value(layout.position[2])};
+  if (!vertex.IsValid()) return false;
+  chunk.vertices_.push_back(vertex);
+  if (layout.HasNormals()) {
+    Coordinate normal{value(layout.normal[0]), value(layout.normal[1]),
+                      value(layout.normal[2])};
+    if (!normal.IsValid()) return false;
+    chunk.normals_.push_back(normal);
+  }
+  if (layout.HasTextures()) {
+    TextureCoordinate texture{value(layout.texture[0]),
+                              value(layout.texture[1])};
+    if (!texture.IsValid()) return false;
+    chunk.textures_.push_back(texture);
+  }
+  return true;
+}
+
+bool ReadFace(PlyCursor &cursor, const PlyElement &element, int index_list,
+              const VertexLayout &layout, std::uint64_t vertex_count,
+              std::vector<FaceCorner> &corners, ObjChunk &chunk) {
+  corners.clear();
+  for (std::size_t i = 0; i < element.properties.size(); ++i) {
+    const PlyProperty &property = element.properties[i];
+    if (static_cast<int>(i) != index_list) {
+      if (!cursor.Skip(property)) return false;
+      continue;
+    }
+    std::uint64_t count = 0;
+    if (!cursor.ReadCount(property, count) || count < 3) return false;
+    for (std::uint64_t k = 0; k < count; ++k) {
+      double index = 0.0;
+      if (!cursor.Read(property.type, index) || index < 0.0 ||
+          index >= static_cast<double>(vertex_count)) {
+        return false;
+      }
+      // Corners are one-based like OBJ references
+      std::uint64_t v = static_cast<std::uint64_t>(index) + 1;
+      corners.push_back({v, layout.HasTextures() ? v : 0,
+                         layout.HasNormals() ? v : 0});
+    }
+  }
+  chunk.AppendPolygon(corners);
+  return true;
+}
+}  // namespace
+
+bool HasPlyMagic(std::string_view head) {
+  return head.starts_with("ply\n") || head.starts_with("ply\r\n");
+}
+
+ErrorCode ParseBinaryPly(std::string_view data, ObjChunk &chunk,
+                         unsigned /*thread_count*/) {
+  std::vector<PlyElement> elements;
+  std::size_t body = 0;
+  std::string error;
+  if (!ParseHeader(data, elements, body, error)) {
+    LogError("ParsePly", error);
+    return invalid_format;
+  }
+  const PlyElement *vertex_element = nullptr;
+  const PlyElement *face_element = nullptr;
+  for (const PlyElement &element : elements) {
+    if (element.name == "vertex") vertex_element = &element;
+    if (element.name == "face") face_element = &element;
+  }
+  VertexLayout layout;
+  if (vertex_element != nullptr) {
+    layout = {{FindProperty(*vertex_element, {"x"}),
+               FindProperty(*vertex_element, {"y"}),
+               FindProperty(*vertex_element, {"z"})},
+              {FindProperty(*vertex_element, {"nx"}),
+               FindProperty(*vertex_element, {"ny"}),
+               FindProperty(*vertex_element, {"nz"})},
+              {FindProperty(*vertex_element, {"u", "s", "texture_u"}),
+               FindProperty(*vertex_element, {"v", "t", "texture_v"})}};
+  }
+  if (vertex_element == nullptr || layout.position[0] < 0 ||
+      layout.position[1] < 0 || layout.position[2] < 0) {
+    LogError("ParsePly", "File has no vertex positions");
+    return invalid_format;
+  }
+  int index_list = face_element == nullptr
+                       ? -1
+                       : FindProperty(*face_element,
+                                      {"vertex_indices", "vertex_index"});
+  if (face_element != nullptr &&
+      (index_list < 0 || !face_element->properties[index_list].is_list)) {
+    LogError("ParsePly", "Faces have no vertex_indices list");
+    return invalid_format;
+  }
+
+  // Attributes belong to the vertex: one of each per vertex
+  std::uint64_t vertex_count = vertex_element->count;
+  chunk.vertices_.reserve(vertex_count);
+  if (layout.HasNormals()) chunk.normals_.reserve(vertex_count);
+  if (layout.HasTextures()) chunk.textures_.reserve(vertex_count);
+  if (face_element != nullptr && vertex_count < kNoIndex) {
+    chunk.faces_.reserve(face_element->count);
+  }
+  ErrorCode result_code = chunk.CheckPoint(0);
+
+  PlyCursor cursor(data, body);
+  std::vector<double> values;
+  std::vector<FaceCorner> corners;
+  std::size_t reported = 0;
+  std::uint64_t records = 0;
+  for (const PlyElement &element : elements) {
+    values.assign(element.properties.size(), 0.0);
+    for (std::uint64_t i = 0;
+         i < element.count && result_code == success_code; ++i) {
+      bool is_read = true;
+      if (&element == vertex_element) {
+        is_read = ReadVertex(cursor, element, layout, values, chunk);
+      } else if (&element == face_element) {
+        is_read = ReadFace(cursor, element, index_list, layout, vertex_count,
+                           corners, chunk);
+      } else {
+        for (const PlyProperty &property : element.properties) {
+          is_read = is_read && cursor.Skip(property);
+        }
+      }
+      if (!is_read) {
+        LogError("ParsePly", "Invalid " + element.name + " " +
+                                 std::to_string(i) + " or truncated file");
+        return invalid_format;
+      }
+      if (++records % kProgressLines == 0) {
+        chunk.count_.v = chunk.vertices_.size();
+        result_code = chunk.CheckPoint(cursor.GetPosition() - reported);
+        reported = cursor.GetPosition();
+      }
+    }
+    if (result_code != success_code) return result_code;
+  }
+  chunk.count_.v = chunk.vertices_.size();
+  chunk.count_.vt = chunk.textures_.size();
+  chunk.count_.vn = chunk.normals_.size();
+  return chunk.CheckPoint(data.size() - reported);
+}
+}  // namespace s21
@@ -0,0 +1,27 @@
+#ifndef MODEL_PLY_LOADER_H
+#define MODEL_PLY_LOADER_H
+
+#include <string_view>
+
+#include "model/errors.h"
+#include "model/obj_chunk.h"
+
+namespace s21 {
+// Text header of every PLY file, binary or not
+bool HasPlyMagic(std::string_view head);
+
+/**
+ * @brief Loads a whole binary little-endian PLY file into chunk
+ *
+ * Vertices take x, y, z and, when present, nx, ny, nz as normals and u, v
+ * (or s, t) as texture coordinates. These attributes belong to the vertex,
+ * so every face corner uses the same index for all three. Faces come from
+ * the vertex_indices list of the face element. Polygons are triangulated
+ * like OBJ faces. Any other element or property is skipped. ASCII and
+ * big-endian files are refused.
+ */
+ErrorCode ParseBinaryPly(std::string_view data, ObjChunk &chunk,
+                         unsigned thread_count);
+}  // namespace s21
+
+#endif  // MODEL_PLY_LOADER_H
@@ -0,0 +1,110 @@
+#ifndef MODEL_SIMD_SCANNER_H
+#define MODEL_SIMD_SCANNER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace s21 {
+
+// Bytes classified per scan step, one bit of the mask per byte
+const std::size_t kScanBlockSize = 64;
+
+/**
+ * @brief Bitmask of the bytes equal to c in a full 64-byte block
+ *
+ * Uses AVX2 (2 x 32 bytes) or SSE2 (4 x 16 bytes) when the compiler targets
+ * them and a plain loop otherwise, e.g. on ARM.
+ */
+inline std::uint64_t MatchBlock(const char *block, char c) {
+#if defined(__AVX2__)
+  const __m256i needle = _mm256_set1_epi8(c);
+  std::uint64_t low = static_cast<std::uint32_t>(_mm256_movemask_epi8(
+      _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)block), needle)));
+  std::uint64_t high = static_cast<std::uint32_t>(
+      _mm256_movemask_epi8(_mm256_cmpeq_epi8(
+          _mm256_loadu_si256((const __m256i *)(block + 32)), needle)));
+  return low | high << 32;
+#elif defined(__SSE2__)
+  const __m128i needle = _mm_set1_epi8(c);
+  std::uint64_t mask = 0;
+  for (int i = 0; i < 4; ++i) {
+    __m128i bytes = _mm_loadu_si128((const __m128i *)(block + i * 16));
+    mask |= static_cast<std::uint64_t>(static_cast<std::uint16_t>(
+                _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, needle))))
+            << (i * 16);
+  }
+  return mask;
+#else
+  std::uint64_t mask = 0;
+  for (std::size_t i = 0; i < kScanBlockSize; ++i) {
+    mask |= static_cast<std::uint64_t>(block[i] == c) << i;
+  }
+  return mask;
+#endif
+}
+
+// Same as MatchBlock for the last, partial block: never reads past the end
+inline std::uint64_t MatchTail(const char *block, std::size_t size, char c) {
+  std::uint64_t mask = 0;
+  for (std::size_t i = 0; i < size; ++i) {
+    mask |= static_cast<std::uint64_t>(block[i] == c) << i;
+  }
+  return mask;
+}
+
+/**
+ * @class LineScanner
+ * @brief Splits a buffer into lines 64 bytes at a time
+ *
+ * Every block is classified once into a newline bitmask, then lines are
+ * handed out by popping set bits, so short lines cost a few instructions
+ * instead of a memchr call each. Lines exclude the '\n'; a last line
+ * without a trailing newline is still returned.
+ */
+class LineScanner {
+ public:
+  explicit LineScanner(std::string_view buffer)
+      : line_start_(buffer.data()),
+        block_(buffer.data()),
+        end_(buffer.data() + buffer.size()) {
+    ScanBlock();
+  }
+
+  bool Next(std::string_view &line) {
+    if (line_start_ >= end_) return false;
+    while (mask_ == 0) {
+      block_ += kScanBlockSize;
+      if (block_ >= end_) {
+        line = std::string_view(line_start_, end_ - line_start_);
+        line_start_ = end_;
+        return true;
+      }
+      ScanBlock();
+    }
+    const char *newline = block_ + __builtin_ctzll(mask_);
+    mask_ &= mask_ - 1;
+    line = std::string_view(line_start_, newline - line_start_);
+    line_start_ = newline + 1;
+    return true;
+  }
+
+ private:
+  void ScanBlock() {
+    std::size_t left = static_cast<std::size_t>(end_ - block_);
+    mask_ = left >= kScanBlockSize ? MatchBlock(block_, '\n')
+                                   : MatchTail(block_, left, '\n');
+  }
+
+  const char *line_start_;
+  const char *block_;
+  const char *end_;
+  std::uint64_t mask_{0};
+};  // class LineScanner
+}  // namespace s21
+
+#endif  // MODEL_SIMD_SCANNER_H
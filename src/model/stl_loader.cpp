@@ -0,0 +1,86 @@
+#include "model/stl_loader.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstring>
+
+#include "model/parallel.h"
+#include "model/vertex_weld.h"
+
+namespace s21 {
+namespace {
+// The corners are copied as they are stored: little-endian floats
+static_assert(std::endian::native == std::endian::little);
+const std::size_t kStlNormalBytes = 12;
+const std::size_t kStlBlockTriangles = kWeldBlockCorners / 3;
+
+std::uint64_t ReadTriangleCount(std::string_view data) {
+  std::uint32_t count = 0;
+  std::memcpy(&count, data.data() + kStlHeaderBytes, sizeof(count));
+  return count;
+}
+
+template <typename F>
+void WeldInto(ArenaVector<F> &faces, ObjChunk &chunk,
+              std::span<const Coordinate> corners, unsigned thread_count) {
+  faces.resize(corners.size() / 3);
+  WeldCorners<F>(corners, chunk.vertices_, faces, thread_count);
+}
+}  // namespace
+
+bool IsBinaryStl(std::string_view head, std::uintmax_t file_size) {
+  return head.size() >= kStlPreambleBytes &&
+         kStlPreambleBytes + ReadTriangleCount(head) * kStlTriangleBytes ==
+             file_size;
+}
+
+ErrorCode ParseBinaryStl(std::string_view data, ObjChunk &chunk,
+                         unsigned thread_count) {
+  if (!IsBinaryStl(data, data.size())) {
+    LogError("ParseStl", data.starts_with("solid")
+                             ? "ASCII STL files are not supported"
+                             : "Triangle count doesn't match the file size");
+    return invalid_format;
+  }
+  std::uint64_t triangle_count = ReadTriangleCount(data);
+  ArenaVector<Coordinate> corners(
+      triangle_count * 3, Coordinate(),
+      ArenaAllocator<Coordinate>(chunk.vertices_.get_allocator()));
+  std::size_t block_count =
+      (triangle_count + kStlBlockTriangles - 1) / kStlBlockTriangles;
+  std::atomic<bool> is_valid{true};
+  ParallelFor(block_count, thread_count, [&](std::size_t block) {
+    std::size_t begin = block * kStlBlockTriangles;
+    std::size_t end = std::min(triangle_count, begin + kStlBlockTriangles);
+    const char *triangle =
+        data.data() + kStlPreambleBytes + begin * kStlTriangleBytes;
+    for (std::size_t i = begin; i < end; ++i) {
+      std::memcpy(&corners[i * 3], triangle + kStlNormalBytes,
+                  3 * sizeof(Coordinate));
+      triangle += kStlTriangleBytes;
+    }
+    for (std::size_t i = begin * 3; i < end * 3; ++i) {
+      if (!corners[i].IsValid()) is_valid = false;
+    }
+  });
+  if (!is_valid) {
+    LogError("ParseStl", "Triangle corner is not a number");
+    return invalid_format;
+  }
+  ErrorCode result_code = chunk.CheckPoint(0);
+  if (result_code != success_code) return result_code;
+
+  // Welding can't leave more vertices than there are corners
+  if (corners.size() >= kNoIndex) chunk.Widen();
+  if (chunk.GetIndexWidth() == kIndex32) {
+    WeldInto(chunk.faces_, chunk, corners, thread_count);
+  } else {
+    WeldInto(chunk.wide_faces_, chunk, corners, thread_count);
+  }
+  ReleaseStorage(corners);
+  chunk.count_.v = chunk.vertices_.size();
+  chunk.count_.f = triangle_count;
+  return chunk.CheckPoint(data.size());
+}
+}  // namespace s21
@@ -0,0 +1,31 @@
+#ifndef MODEL_STL_LOADER_H
+#define MODEL_STL_LOADER_H
+
+#include <cstdint>
+#include <string_view>
+
+#include "model/errors.h"
+#include "model/obj_chunk.h"
+
+namespace s21 {
+// Binary STL: an 80-byte header, a 32-bit triangle count and 50 bytes per
+// triangle (normal, three corners, attribute word)
+const std::size_t kStlHeaderBytes = 80;
+const std::size_t kStlPreambleBytes = kStlHeaderBytes + 4;
+const std::size_t kStlTriangleBytes = 50;
+
+// The triangle count matches the file size exactly; ASCII STL never does
+bool IsBinaryStl(std::string_view head, std::uintmax_t file_size);
+
+/**
+ * @brief Loads a whole binary STL file into chunk
+ *
+ * The corners are copied out of the file in parallel blocks and welded into
+ * shared vertices (WeldCorners), since STL repeats every position for each
+ * triangle using it. Facet normals are not kept.
+ */
+ErrorCode ParseBinaryStl(std::string_view data, ObjChunk &chunk,
+                         unsigned thread_count);
+}  // namespace s21
+
+#endif  // MODEL_STL_LOADER_H
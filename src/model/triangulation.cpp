@@ -0,0 +1,172 @@
+#include "model/triangulation.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+
+#include "model/parallel.h"
+
+namespace s21 {
+namespace {
+using Point = std::array<double, 2>;
+
+// Polygons handed to one thread share these arrays
+template <typename F>
+struct ClipScratch {
+  std::vector<typename F::IndexType> v, vt, vn;
+  std::vector<Point> points;
+  std::vector<std::size_t> ring;
+};
+
+// Twice the signed area of triangle abc, positive when it turns left
+double Cross(const Point &a, const Point &b, const Point &c) {
+  return (b[0] - a[0]) * (c[1] - a[1]) - (b[1] - a[1]) * (c[0] - a[0]);
+}
+
+bool IsInside(const Point &p, const Point &a, const Point &b,
+              const Point &c) {
+  return Cross(a, b, p) >= 0.0 && Cross(b, c, p) >= 0.0 &&
+         Cross(c, a, p) >= 0.0;
+}
+
+// Corners of a fan in polygon order: (0, 1, 2), (0, 2, 3), ...
+template <typename F>
+void ReadCorners(std::span<const F> column, const PolygonRun &run,
+                 std::vector<typename F::IndexType> &corners) {
+  corners.clear();
+  if (column.empty()) return;
+  corners.push_back(column[run.first_face].index[0]);
+  corners.push_back(column[run.first_face].index[1]);
+  for (std::uint64_t i = 0; i + 2 < run.corner_count; ++i) {
+    corners.push_back(column[run.first_face + i].index[2]);
+  }
+}
+
+// Drops the axis the polygon normal (Newell's method) is largest along and
+// orients the projection so that the polygon runs counter-clockwise
+template <typename F>
+void ProjectCorners(std::span<const Coordinate> vertices,
+                    ClipScratch<F> &scratch) {
+  std::size_t n = scratch.v.size();
+  double nx = 0.0, ny = 0.0, nz = 0.0;
+  for (std::size_t i = 0; i < n; ++i) {
+    const Coordinate &a = vertices[scratch.v[i]];
+    const Coordinate &b = vertices[scratch.v[(i + 1) % n]];
+    nx += (a.y - b.y) * (a.z + b.z);
+    ny += (a.z - b.z) * (a.x + b.x);
+    nz += (a.x - b.x) * (a.y + b.y);
+  }
+  scratch.points.clear();
+  for (std::size_t i = 0; i < n; ++i) {
+    const Coordinate &a = vertices[scratch.v[i]];
+    if (std::abs(nz) >= std::abs(nx) && std::abs(nz) >= std::abs(ny)) {
+      scratch.points.push_back({a.x, nz >= 0.0 ? a.y : -a.y});
+    } else if (std::abs(nx) >= std::abs(ny)) {
+      scratch.points.push_back({a.y, nx >= 0.0 ? a.z : -a.z});
+    } else {
+      scratch.points.push_back({a.z, ny >= 0.0 ? a.x : -a.x});
+    }
+  }
+}
+
+template <typename F>
+bool IsEar(const ClipScratch<F> &scratch, std::size_t position) {
+  const std::vector<std::size_t> &ring = scratch.ring;
+  std::size_t m = ring.size();
+  std::size_t prev = ring[(position + m - 1) % m], cur = ring[position],
+              next = ring[(position + 1) % m];
+  const Point &a = scratch.points[prev], &b = scratch.points[cur],
+              &c = scratch.points[next];
+  if (Cross(a, b, c) <= 0.0) return false;
+  for (std::size_t corner : ring) {
+    if (corner != prev && corner != cur && corner != next &&
+        IsInside(scratch.points[corner], a, b, c)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename F>
+void ClipPolygon(std::span<const Coordinate> vertices, const PolygonRun &run,
+                 std::span<F> faces, std::span<F> texture_faces,
+                 std::span<F> normal_faces, std::span<FaceEdgeMask> face_edges,
+                 ClipScratch<F> &scratch) {
+  ReadCorners<F>(faces, run, scratch.v);
+  ReadCorners<F>(texture_faces, run, scratch.vt);
+  ReadCorners<F>(normal_faces, run, scratch.vn);
+  ProjectCorners(vertices, scratch);
+  std::size_t n = scratch.v.size();
+  scratch.ring.resize(n);
+  for (std::size_t i = 0; i < n; ++i) scratch.ring[i] = i;
+
+  std::uint64_t face = run.first_face;
+  auto emit = [&](std::size_t a, std::size_t b, std::size_t c) {
+    auto write = [&](const std::vector<typename F::IndexType> &corners,
+                     std::span<F> column) {
+      if (corners.empty()) return;
+      column[face] = {{corners[a], corners[b], corners[c]}};
+    };
+    write(scratch.v, faces);
+    write(scratch.vt, texture_faces);
+    write(scratch.vn, normal_faces);
+    // An edge is on the outline when it joins neighbouring corners
+    face_edges[face] = (b == (a + 1) % n ? 0b001 : 0) |
+                       (c == (b + 1) % n ? 0b010 : 0) |
+                       (a == (c + 1) % n ? 0b100 : 0);
+    face++;
+  };
+
+  std::size_t position = 0, misses = 0;
+  while (scratch.ring.size() > 3) {
+    std::size_t m = scratch.ring.size();
+    position %= m;
+    // A degenerate polygon may have no ear left: cut one anyway
+    if (misses >= m || IsEar(scratch, position)) {
+      emit(scratch.ring[(position + m - 1) % m], scratch.ring[position],
+           scratch.ring[(position + 1) % m]);
+      scratch.ring.erase(scratch.ring.begin() + position);
+      misses = 0;
+    } else {
+      position++;
+      misses++;
+    }
+  }
+  emit(scratch.ring[0], scratch.ring[1], scratch.ring[2]);
+}
+}  // namespace
+
+template <typename F>
+void EarClipPolygons(std::span<const Coordinate> vertices,
+                     std::span<const PolygonRun> polygons,
+                     std::span<F> faces, std::span<F> texture_faces,
+                     std::span<F> normal_faces,
+                     std::span<FaceEdgeMask> face_edges,
+                     unsigned thread_count) {
+  // A few blocks per thread, each with its own scratch arrays
+  std::size_t block_count = std::min<std::size_t>(
+      polygons.size(), ResolveThreadCount(thread_count) * 4);
+  ParallelFor(block_count, thread_count, [&](std::size_t block) {
+    ClipScratch<F> scratch;
+    std::size_t begin = polygons.size() * block / block_count;
+    std::size_t end = polygons.size() * (block + 1) / block_count;
+    for (std::size_t i = begin; i < end; ++i) {
+      ClipPolygon(vertices, polygons[i], faces, texture_faces, normal_faces,
+                  face_edges, scratch);
+    }
+  });
+}
+
+template void EarClipPolygons<Face>(std::span<const Coordinate>,
+                                    std::span<const PolygonRun>,
+                                    std::span<Face>, std::span<Face>,
+                                    std::span<Face>, std::span<FaceEdgeMask>,
+                                    unsigned);
+template void EarClipPolygons<WideFace>(std::span<const Coordinate>,
+                                        std::span<const PolygonRun>,
+                                        std::span<WideFace>,
+                                        std::span<WideFace>,
+                                        std::span<WideFace>,
+                                        std::span<FaceEdgeMask>, unsigned);
+}  // namespace s21
@@ -0,0 +1,34 @@
+#ifndef MODEL_TRIANGULATION_H
+#define MODEL_TRIANGULATION_H
+
+#include <cstdint>
+#include <span>
+
+#include "model/mesh_types.h"
+
+namespace s21 {
+// A polygon the parser fanned out into corner_count - 2 consecutive faces
+struct PolygonRun {
+  std::uint64_t first_face = 0;
+  std::uint64_t corner_count = 0;
+};
+
+/**
+ * @brief Re-triangulates fanned polygons by ear clipping, in place
+ *
+ * The corners of every polygon are read back from its fan, the polygon is
+ * projected onto the plane it mostly faces and cut into the same number of
+ * triangles, so the faces keep their slots. Texture and normal faces (when
+ * not empty) follow the vertex faces and face_edges gets the outline masks of
+ * the new triangles. Polygons are spread over thread_count threads.
+ */
+template <typename F>
+void EarClipPolygons(std::span<const Coordinate> vertices,
+                     std::span<const PolygonRun> polygons,
+                     std::span<F> faces, std::span<F> texture_faces,
+                     std::span<F> normal_faces,
+                     std::span<FaceEdgeMask> face_edges,
+                     unsigned thread_count);
+}  // namespace s21
+
+#endif  // MODEL_TRIANGULATION_H
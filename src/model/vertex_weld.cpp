@@ -0,0 +1,317 @@
+#include "model/vertex_weld.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+
+#include "model/parallel.h"
+
+namespace s21 {
+namespace {
+struct CornerKey {
+  std::uint32_t x, y, z;
+  bool operator==(const CornerKey &other) const = default;
+};
+
+CornerKey KeyOf(const Coordinate &corner) {
+  // Adding zero turns -0 into +0 and leaves every other value alone
+  return {std::bit_cast<std::uint32_t>(corner.x + 0.0f),
+          std::bit_cast<std::uint32_t>(corner.y + 0.0f),
+          std::bit_cast<std::uint32_t>(corner.z + 0.0f)};
+}
+
+std::uint32_t HashKey(const CornerKey &key) {
+  std::uint32_t hash =
+      key.x * 0x9e3779b1u ^ key.y * 0x85ebca77u ^ key.z * 0xc2b2ae3du;
+  return hash ^ (hash >> 16);
+}
+
+const std::uint64_t kNoVertex = UINT64_MAX;
+// Cells further out are clamped, which keeps the conversion from double
+// and the neighbour offsets within 64 bits
+const double kMaxCell = 1ll << 52;
+
+struct GridCell {
+  std::int64_t x, y, z;
+  bool operator==(const GridCell &other) const = default;
+};
+
+// The part of the hash grid one thread fills: open addressing, each slot
+// holds the first and last vertex of a cell
+struct GridPart {
+  std::vector<std::uint64_t> heads, tails;
+  std::uint64_t mask = 0;
+};
+
+class WeldGrid {
+ public:
+  WeldGrid(std::span<const Coordinate> vertices, float epsilon,
+           unsigned thread_count)
+      : vertices_(vertices),
+        epsilon_(epsilon),
+        inverse_(epsilon > 0 ? 0.5 / epsilon : 0.0),
+        hashes_(vertices.size()),
+        next_(vertices.size(), kNoVertex) {
+    unsigned part_count = std::bit_ceil(
+        std::min(ResolveThreadCount(thread_count), 64u));
+    part_shift_ = 64 - std::countr_zero(part_count);
+    parts_.resize(part_count);
+
+    // Vertices are bucketed by part with a counting sort, in order within
+    // each part, so that every part reads only its own vertices
+    std::size_t count = vertices_.size();
+    std::size_t block_count =
+        (count + kWeldBlockCorners - 1) / kWeldBlockCorners;
+    std::vector<std::uint64_t> cursors(block_count * part_count, 0);
+    ParallelFor(block_count, thread_count, [&](std::size_t block) {
+      std::uint64_t *counts = &cursors[block * part_count];
+      std::size_t end = std::min(count, (block + 1) * kWeldBlockCorners);
+      for (std::size_t i = block * kWeldBlockCorners; i < end; ++i) {
+        hashes_[i] = HashCell(CellOf(vertices_[i]));
+        ++counts[PartOf(hashes_[i])];
+      }
+    });
+    std::vector<std::uint64_t> part_starts(part_count + 1, 0);
+    std::uint64_t offset = 0;
+    for (std::size_t part = 0; part < part_count; ++part) {
+      part_starts[part] = offset;
+      for (std::size_t block = 0; block < block_count; ++block) {
+        std::uint64_t block_members = cursors[block * part_count + part];
+        cursors[block * part_count + part] = offset;
+        offset += block_members;
+      }
+    }
+    part_starts[part_count] = offset;
+
+    std::vector<std::uint64_t> members(count);
+    ParallelFor(block_count, thread_count, [&](std::size_t block) {
+      std::uint64_t *next = &cursors[block * part_count];
+      std::size_t end = std::min(count, (block + 1) * kWeldBlockCorners);
+      for (std::size_t i = block * kWeldBlockCorners; i < end; ++i) {
+        members[next[PartOf(hashes_[i])]++] = i;
+      }
+    });
+    ParallelFor(part_count, thread_count, [&](std::size_t part) {
+      FillPart(part, std::span<const std::uint64_t>(
+                         members.data() + part_starts[part],
+                         members.data() + part_starts[part + 1]));
+    });
+  }
+
+  // The first vertex before i that lies within epsilon of it, or i itself
+  std::uint64_t FindEarlier(std::uint64_t i) const {
+    const Coordinate &vertex = vertices_[i];
+    GridCell cell = CellOf(vertex);
+    // Cells are two epsilons wide: a close vertex is in this cell or in the
+    // neighbour on the side of the cell nearer to the vertex, on each axis
+    GridCell side = {NearerSide(vertex.x, cell.x), NearerSide(vertex.y, cell.y),
+                     NearerSide(vertex.z, cell.z)};
+    float limit = epsilon_ * epsilon_;
+    std::uint64_t first = i;
+    for (int corner = 0; corner < 8; ++corner) {
+      GridCell neighbour = {cell.x + (corner & 1 ? side.x : 0),
+                            cell.y + (corner & 2 ? side.y : 0),
+                            cell.z + (corner & 4 ? side.z : 0)};
+      if (neighbour == cell && corner != 0) continue;
+      // Cells list their vertices in order, only earlier ones can win
+      for (std::uint64_t j = FindHead(neighbour); j < first; j = next_[j]) {
+        if (SquaredDistance(vertex, vertices_[j]) <= limit) {
+          first = j;
+          break;
+        }
+      }
+    }
+    return first;
+  }
+
+  template <typename Task>
+  void ForEachBlock(unsigned thread_count, Task task) const {
+    std::size_t count = vertices_.size();
+    std::size_t block_count =
+        (count + kWeldBlockCorners - 1) / kWeldBlockCorners;
+    ParallelFor(block_count, thread_count, [&](std::size_t block) {
+      std::size_t end = std::min(count, (block + 1) * kWeldBlockCorners);
+      for (std::size_t i = block * kWeldBlockCorners; i < end; ++i) task(i);
+    });
+  }
+
+ private:
+  GridCell CellOf(const Coordinate &vertex) const {
+    if (inverse_ == 0) {
+      CornerKey key = KeyOf(vertex);
+      return {key.x, key.y, key.z};
+    }
+    auto axis = [this](float value) {
+      double cell = std::floor(value * inverse_);
+      return static_cast<std::int64_t>(std::clamp(cell, -kMaxCell, kMaxCell));
+    };
+    return {axis(vertex.x), axis(vertex.y), axis(vertex.z)};
+  }
+
+  // -1 or +1 towards the nearer face of the cell, 0 for exact matching
+  std::int64_t NearerSide(float value, std::int64_t cell) const {
+    if (inverse_ == 0) return 0;
+    return value * inverse_ - static_cast<double>(cell) < 0.5 ? -1 : 1;
+  }
+
+  static std::uint64_t HashCell(const GridCell &cell) {
+    std::uint64_t hash = static_cast<std::uint64_t>(cell.x) *
+                             0x9e3779b97f4a7c15ull ^
+                         static_cast<std::uint64_t>(cell.y) *
+                             0xc2b2ae3d27d4eb4full ^
+                         static_cast<std::uint64_t>(cell.z) *
+                             0x165667b19e3779f9ull;
+    return hash ^ (hash >> 29);
+  }
+
+  static float SquaredDistance(const Coordinate &a, const Coordinate &b) {
+    float dx = a.x - b.x, dy = a.y - b.y, dz = a.z - b.z;
+    return dx * dx + dy * dy + dz * dz;
+  }
+
+  std::size_t PartOf(std::uint64_t hash) const {
+    return part_shift_ == 64 ? 0 : hash >> part_shift_;
+  }
+
+  // Inserts the vertices of one part in order, appending to their cell
+  void FillPart(std::size_t part, std::span<const std::uint64_t> members) {
+    GridPart &grid = parts_[part];
+    std::size_t slot_count =
+        std::bit_ceil(std::max<std::size_t>(members.size() * 2, 16));
+    grid.heads.assign(slot_count, kNoVertex);
+    grid.tails.assign(slot_count, kNoVertex);
+    grid.mask = slot_count - 1;
+    for (std::uint64_t i : members) {
+      std::uint64_t slot = FindSlot(grid, hashes_[i], CellOf(vertices_[i]));
+      if (grid.heads[slot] == kNoVertex) {
+        grid.heads[slot] = i;
+      } else {
+        next_[grid.tails[slot]] = i;
+      }
+      grid.tails[slot] = i;
+    }
+  }
+
+  std::uint64_t FindSlot(const GridPart &grid, std::uint64_t hash,
+                         const GridCell &cell) const {
+    std::uint64_t slot = hash & grid.mask;
+    while (grid.heads[slot] != kNoVertex &&
+           CellOf(vertices_[grid.heads[slot]]) != cell) {
+      slot = (slot + 1) & grid.mask;
+    }
+    return slot;
+  }
+
+  std::uint64_t FindHead(const GridCell &cell) const {
+    std::uint64_t hash = HashCell(cell);
+    const GridPart &grid = parts_[PartOf(hash)];
+    return grid.heads[FindSlot(grid, hash, cell)];
+  }
+
+  std::span<const Coordinate> vertices_;
+  float epsilon_;
+  double inverse_;
+  std::vector<std::uint64_t> hashes_;
+  // The next vertex in the same cell
+  std::vector<std::uint64_t> next_;
+  std::vector<GridPart> parts_;
+  int part_shift_ = 64;
+};
+}  // namespace
+
+template <typename F>
+void WeldCorners(std::span<const Coordinate> corners,
+                 ArenaVector<Coordinate> &vertices, std::span<F> faces,
+                 unsigned thread_count) {
+  using Index = typename F::IndexType;
+  std::size_t count = corners.size();
+  ArenaAllocator<std::uint32_t> allocator(vertices.get_allocator());
+  ArenaVector<std::uint32_t> hashes(count, 0, allocator);
+  std::size_t block_count = (count + kWeldBlockCorners - 1) / kWeldBlockCorners;
+  ParallelFor(block_count, thread_count, [&](std::size_t block) {
+    std::size_t begin = block * kWeldBlockCorners;
+    std::size_t end = std::min(count, begin + kWeldBlockCorners);
+    for (std::size_t i = begin; i < end; ++i) {
+      hashes[i] = HashKey(KeyOf(corners[i]));
+    }
+  });
+
+  // Open addressing with at most half of the slots taken
+  const Index empty = static_cast<Index>(-1);
+  std::size_t slot_count = std::bit_ceil(std::max<std::size_t>(count * 2, 16));
+  std::size_t mask = slot_count - 1;
+  ArenaVector<Index> slots(slot_count, empty, ArenaAllocator<Index>(allocator));
+  // Shared meshes have about one vertex per six corners
+  vertices.reserve(vertices.size() + count / 4);
+  for (std::size_t i = 0; i < count; ++i) {
+    CornerKey key = KeyOf(corners[i]);
+    std::size_t slot = hashes[i] & mask;
+    Index vertex = slots[slot];
+    while (vertex != empty && KeyOf(vertices[vertex]) != key) {
+      slot = (slot + 1) & mask;
+      vertex = slots[slot];
+    }
+    if (vertex == empty) {
+      vertex = static_cast<Index>(vertices.size());
+      slots[slot] = vertex;
+      vertices.push_back({std::bit_cast<float>(key.x),
+                          std::bit_cast<float>(key.y),
+                          std::bit_cast<float>(key.z)});
+    }
+    faces[i / 3].index[i % 3] = vertex;
+  }
+}
+
+template void WeldCorners<Face>(std::span<const Coordinate>,
+                                ArenaVector<Coordinate> &, std::span<Face>,
+                                unsigned);
+template void WeldCorners<WideFace>(std::span<const Coordinate>,
+                                    ArenaVector<Coordinate> &,
+                                    std::span<WideFace>, unsigned);
+
+void WeldPositions(std::span<const Coordinate> vertices, float epsilon,
+                   unsigned thread_count, ArenaVector<Coordinate> &welded,
+                   std::vector<std::uint64_t> &remap) {
+  std::size_t count = vertices.size();
+  WeldGrid grid(vertices, epsilon, thread_count);
+  std::vector<std::uint64_t> links(count);
+  grid.ForEachBlock(thread_count, [&](std::size_t i) {
+    links[i] = grid.FindEarlier(i);
+  });
+  // Links only point backwards, so every chain ends at a vertex that stays
+  remap.resize(count);
+  grid.ForEachBlock(thread_count, [&](std::size_t i) {
+    std::uint64_t root = links[i];
+    while (links[root] != root) root = links[root];
+    remap[i] = root;
+  });
+
+  // The surviving vertices of a block go after those of earlier blocks
+  std::size_t block_count =
+      (count + kWeldBlockCorners - 1) / kWeldBlockCorners;
+  std::vector<std::uint64_t> offsets(block_count + 1, 0);
+  ParallelFor(block_count, thread_count, [&](std::size_t block) {
+    std::size_t end = std::min(count, (block + 1) * kWeldBlockCorners);
+    for (std::size_t i = block * kWeldBlockCorners; i < end; ++i) {
+      offsets[block + 1] += remap[i] == i;
+    }
+  });
+  for (std::size_t block = 0; block < block_count; ++block) {
+    offsets[block + 1] += offsets[block];
+  }
+  welded.resize(offsets[block_count]);
+  ParallelFor(block_count, thread_count, [&](std::size_t block) {
+    std::uint64_t next = offsets[block];
+    std::size_t end = std::min(count, (block + 1) * kWeldBlockCorners);
+    for (std::size_t i = block * kWeldBlockCorners; i < end; ++i) {
+      if (remap[i] != i) continue;
+      // links is free now; it carries the new index of every survivor
+      links[i] = next;
+      welded[next++] = vertices[i];
+    }
+  });
+  grid.ForEachBlock(thread_count,
+                    [&](std::size_t i) { remap[i] = links[remap[i]]; });
+}
+}  // namespace s21
@@ -0,0 +1,51 @@
+#ifndef MODEL_VERTEX_WELD_H
+#define MODEL_VERTEX_WELD_H
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "model/arena.h"
+#include "model/mesh_types.h"
+
+namespace s21 {
+// Corners hashed by one thread at a time
+const std::size_t kWeldBlockCorners = 1 << 16;
+
+/**
+ * @brief Merges triangle corners at the same position into shared vertices
+ *
+ * Corner i becomes faces[i / 3].index[i % 3]. vertices receives the distinct
+ * positions in the order they are first used. Positions match when their
+ * bits match, with -0 and +0 counted as the same. The corners are hashed up
+ * front on thread_count threads by a branch-free loop that the compiler
+ * vectorises. The lookup after it runs serially, so the vertex order does
+ * not depend on the thread count. Scratch arrays come from the allocator of
+ * vertices.
+ */
+template <typename F>
+void WeldCorners(std::span<const Coordinate> corners,
+                 ArenaVector<Coordinate> &vertices, std::span<F> faces,
+                 unsigned thread_count);
+
+/**
+ * @brief Merges vertices that lie within epsilon of each other
+ *
+ * Vertices are binned into a hash grid of cells two epsilons wide. Each
+ * vertex links to the first earlier vertex within epsilon in its own cell or
+ * one of the seven around the nearest cell corner, and follows those links
+ * to the vertex its group becomes.
+ * With epsilon 0 only positions whose bits match (-0 = +0) merge. The grid is
+ * split by hash among thread_count threads. A counting pass buckets the
+ * vertices by part, and each thread fills its part from its bucket in vertex
+ * order, so the result doesn't depend on the thread count.
+ *
+ * welded receives the surviving positions in their original order, remap the
+ * index in welded of every input vertex.
+ */
+void WeldPositions(std::span<const Coordinate> vertices, float epsilon,
+                   unsigned thread_count, ArenaVector<Coordinate> &welded,
+                   std::vector<std::uint64_t> &remap);
+}  // namespace s21
+
+#endif  // MODEL_VERTEX_WELD_H
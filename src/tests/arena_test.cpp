@@ -0,0 +1,51 @@
+#include "model/arena.h"
+
+#include <cstdint>
+#include <new>
+
+#include "gtest/gtest.h"
+
+TEST(ArenaTest, allocations_are_aligned_and_ordered) {
+  s21::Arena arena(1 << 20);
+  ASSERT_TRUE(arena.IsReserved());
+  EXPECT_GE(arena.GetCapacity(), 1u << 20);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(arena.Allocate(1, 1)) %
+                s21::kArenaHugePageBytes,
+            0);
+  char *second = static_cast<char *>(arena.Allocate(10, 4));
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(second) % s21::kArenaAlignment,
+            0);
+  EXPECT_TRUE(arena.Contains(second));
+  EXPECT_EQ(arena.GetUsedBytes(), s21::kArenaAlignment + 10);
+}
+
+TEST(ArenaTest, exhausted_arena_throws) {
+  s21::Arena arena(s21::kArenaHugePageBytes);
+  arena.Allocate(s21::kArenaHugePageBytes - 64, 1);
+  EXPECT_THROW(arena.Allocate(65, 1), std::bad_alloc);
+  EXPECT_NO_THROW(arena.Allocate(64, 1));
+}
+
+TEST(ArenaTest, vector_grows_inside_arena) {
+  s21::Arena arena(64 << 20);
+  s21::ArenaVector<int> values{s21::ArenaAllocator<int>(&arena)};
+  for (int i = 0; i < 1000000; ++i) values.push_back(i);
+  EXPECT_TRUE(arena.Contains(values.data()));
+  EXPECT_EQ(values[999999], 999999);
+  // Released blocks give their pages back but the data moved on intact
+  s21::ReleaseStorage(values);
+  EXPECT_EQ(values.get_allocator().GetArena(), &arena);
+  values.assign(5, 7);
+  EXPECT_TRUE(arena.Contains(values.data()));
+}
+
+TEST(ArenaTest, copies_leave_the_arena) {
+  s21::Arena arena(1 << 20);
+  s21::ArenaVector<int> values({1, 2, 3}, s21::ArenaAllocator<int>(&arena));
+  s21::ArenaVector<int> copy(values);
+  EXPECT_EQ(copy.get_allocator().GetArena(), nullptr);
+  EXPECT_FALSE(arena.Contains(copy.data()));
+  s21::ArenaVector<int> moved(std::move(values));
+  EXPECT_TRUE(arena.Contains(moved.data()));
+  EXPECT_EQ(copy, moved);
+}
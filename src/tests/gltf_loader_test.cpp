@@ -0,0 +1,205 @@
+#include "model/gltf_loader.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "model/parser.h"
+
+namespace {
+class GltfProbe : public s21::WireframeObject {
+ public:
+  using s21::WireframeObject::WireframeObject;
+  bool IsMapped() const { return vertices_.IsMapped() && faces_.IsMapped(); }
+};
+
+class GltfLoaderTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    std::ofstream clear_log("logs/debug.log", std::ios::trunc);
+  }
+  void TearDown() override {
+    for (const std::string &path : paths_) std::filesystem::remove(path);
+  }
+
+  std::string Write(const std::string &name, const std::string &bytes) {
+    paths_.push_back(
+        (std::filesystem::temp_directory_path() / name).string());
+    std::ofstream(paths_.back(), std::ios::binary | std::ios::trunc) << bytes;
+    return paths_.back();
+  }
+
+  // A .glb of the JSON and the BIN chunk, both padded to four bytes
+  std::string WriteGlb(const std::string &name, std::string json,
+                       std::string bin) {
+    json.resize((json.size() + 3) / 4 * 4, ' ');
+    bin.resize((bin.size() + 3) / 4 * 4, '\0');
+    std::string bytes = "glTF";
+    Append<std::uint32_t>(bytes, 2);
+    Append<std::uint32_t>(bytes, 12 + 8 + json.size() + 8 + bin.size());
+    Append<std::uint32_t>(bytes, json.size());
+    Append<std::uint32_t>(bytes, s21::kGlbChunkJson);
+    bytes += json;
+    Append<std::uint32_t>(bytes, bin.size());
+    Append<std::uint32_t>(bytes, s21::kGlbChunkBin);
+    bytes += bin;
+    return Write(name, bytes);
+  }
+
+  std::string GetLastLogMessage() {
+    std::ifstream log_file("logs/debug.log");
+    std::string line, last_line;
+    while (std::getline(log_file, line)) last_line = line;
+    return last_line;
+  }
+
+  template <typename T>
+  static void Append(std::string &bytes, T value) {
+    bytes.append(reinterpret_cast<const char *>(&value), sizeof(T));
+  }
+
+ private:
+  std::vector<std::string> paths_;
+};
+
+const float kSquare[4][3] = {{0, 0, 0}, {1, 0, 0}, {1, 1, 0}, {0, 1, 0}};
+const unsigned kSquareIndices[6] = {0, 1, 2, 0, 2, 3};
+
+// One primitive over a buffer with the positions at 0 and indices after them
+std::string SquareJson(int stride, int component_type, int index_bytes,
+                       const std::string &buffer, const std::string &node) {
+  int positions = stride * 4;
+  return R"({"asset":{"version":"2.0"},"scene":0,"scenes":[{"nodes":[0]}],)"
+         R"("nodes":[)" + node + R"(],)"
+         R"("meshes":[{"primitives":[{"attributes":{"POSITION":0},)"
+         R"("indices":1}]}],"accessors":[)"
+         R"({"bufferView":0,"componentType":5126,"count":4,"type":"VEC3"},)"
+         R"({"bufferView":1,"componentType":)" +
+         std::to_string(component_type) +
+         R"(,"count":6,"type":"SCALAR"}],"bufferViews":[)"
+         R"({"buffer":0,"byteLength":)" + std::to_string(positions) +
+         R"(,"byteStride":)" + std::to_string(stride) + R"(},)"
+         R"({"buffer":0,"byteOffset":)" + std::to_string(positions) +
+         R"(,"byteLength":)" + std::to_string(index_bytes * 6) +
+         R"(}],"buffers":[{)" + buffer + R"("byteLength":)" +
+         std::to_string(positions + index_bytes * 6) + "}]}";
+}
+
+template <typename I>
+std::string SquareBin(int stride, unsigned bad_index = 0) {
+  std::string bin;
+  for (const auto &corner : kSquare) {
+    std::string vertex(stride, '\x7f');
+    std::memcpy(vertex.data(), corner, sizeof(corner));
+    bin += vertex;
+  }
+  for (unsigned index : kSquareIndices) {
+    I value = static_cast<I>(index == 3 && bad_index != 0 ? bad_index : index);
+    bin.append(reinterpret_cast<const char *>(&value), sizeof(value));
+  }
+  return bin;
+}
+
+std::string EncodeBase64(const std::string &bytes) {
+  const char *digits =
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  std::string text;
+  for (std::size_t i = 0; i < bytes.size(); i += 3) {
+    std::uint32_t bits = static_cast<unsigned char>(bytes[i]) << 16;
+    if (i + 1 < bytes.size()) {
+      bits |= static_cast<unsigned char>(bytes[i + 1]) << 8;
+    }
+    if (i + 2 < bytes.size()) bits |= static_cast<unsigned char>(bytes[i + 2]);
+    for (std::size_t k = 0; k < 4; ++k) {
+      bool has_byte = k < 2 || i + k - 1 < bytes.size();
+      text += has_byte ? digits[(bits >> (18 - 6 * k)) & 63] : '=';
+    }
+  }
+  return text;
+}
+}  // namespace
+
+TEST_F(GltfLoaderTest, packed_glb_is_mapped) {
+  std::string path = WriteGlb("3dviewer_square.glb",
+                              SquareJson(12, 5125, 4, "", "{\"mesh\":0}"),
+                              SquareBin<std::uint32_t>(12));
+  EXPECT_EQ(s21::DetectMeshFormat(path).format, s21::kFormatGltf);
+  GltfProbe obj(path);
+  EXPECT_EQ(GetLastLogMessage(), "");
+  ASSERT_EQ(obj.GetVertexCount(), 4);
+  ASSERT_EQ(obj.GetFaceCount(), 2);
+  EXPECT_TRUE(obj.IsMapped());
+  EXPECT_EQ(obj.GetVertices()[2].y, 1.0f);
+  EXPECT_EQ(obj.GetFaces()[1].index[2], 3);
+  EXPECT_EQ(obj.GetBounds().max.x, 1.0f);
+}
+
+TEST_F(GltfLoaderTest, interleaved_positions_are_gathered) {
+  GltfProbe obj(WriteGlb("3dviewer_strided.glb",
+                         SquareJson(24, 5123, 2, "", "{\"mesh\":0}"),
+                         SquareBin<std::uint16_t>(24)));
+  EXPECT_EQ(GetLastLogMessage(), "");
+  ASSERT_EQ(obj.GetVertexCount(), 4);
+  ASSERT_EQ(obj.GetFaceCount(), 2);
+  EXPECT_FALSE(obj.IsMapped());
+  EXPECT_EQ(obj.GetVertices()[3].y, 1.0f);
+  EXPECT_EQ(obj.GetVertices()[3].z, 0.0f);
+  EXPECT_EQ(obj.GetFaces()[1].index[1], 2);
+}
+
+TEST_F(GltfLoaderTest, data_uri_and_node_transform) {
+  std::string buffer = R"("uri":"data:application/octet-stream;base64,)" +
+                       EncodeBase64(SquareBin<std::uint8_t>(12)) + R"(",)";
+  std::string node = R"({"children":[1],"translation":[0,0,5]},)"
+                     R"({"mesh":0,"scale":[2,2,2]})";
+  s21::WireframeObject obj(Write("3dviewer_square.gltf",
+                                 SquareJson(12, 5121, 1, buffer, node)));
+  EXPECT_EQ(GetLastLogMessage(), "");
+  ASSERT_EQ(obj.GetVertexCount(), 4);
+  EXPECT_EQ(obj.GetVertices()[2].x, 2.0f);
+  EXPECT_EQ(obj.GetVertices()[2].z, 5.0f);
+  EXPECT_EQ(obj.GetFaces()[1].index[2], 3);
+}
+
+TEST_F(GltfLoaderTest, errors_are_reported) {
+  s21::WireframeObject bad_index(
+      WriteGlb("3dviewer_bad_index.glb",
+               SquareJson(12, 5125, 4, "", "{\"mesh\":0}"),
+               SquareBin<std::uint32_t>(12, 4)));
+  EXPECT_EQ(bad_index.GetId(), -1);
+  EXPECT_NE(GetLastLogMessage().find("Index 4 is out of range"),
+            std::string::npos);
+
+  std::string bin = SquareBin<std::uint32_t>(12);
+  bin.resize(40);
+  s21::WireframeObject short_buffer(
+      WriteGlb("3dviewer_short.glb",
+               SquareJson(12, 5125, 4, "", "{\"mesh\":0}"), bin));
+  EXPECT_EQ(short_buffer.GetId(), -1);
+  EXPECT_NE(GetLastLogMessage().find("shorter than its byteLength"),
+            std::string::npos);
+
+  std::string shared_child = R"({"children":[1,1]},{"mesh":0})";
+  s21::WireframeObject shared(
+      WriteGlb("3dviewer_shared.glb",
+               SquareJson(12, 5125, 4, "", shared_child),
+               SquareBin<std::uint32_t>(12)));
+  EXPECT_EQ(shared.GetId(), -1);
+  EXPECT_NE(GetLastLogMessage().find("Node 1 has more than one parent"),
+            std::string::npos);
+
+  s21::WireframeObject cycle(
+      WriteGlb("3dviewer_cycle.glb",
+               SquareJson(12, 5125, 4, "", R"({"mesh":0,"children":[0]})"),
+               SquareBin<std::uint32_t>(12)));
+  EXPECT_EQ(cycle.GetId(), -1);
+  EXPECT_NE(GetLastLogMessage().find("Node 0 has more than one parent"),
+            std::string::npos);
+
+  s21::WireframeObject not_json(Write("3dviewer_broken.gltf", "{\"asset\":"));
+  EXPECT_EQ(not_json.GetId(), -1);
+  EXPECT_NE(GetLastLogMessage().find("GltfLoader"), std::string::npos);
+}
@@ -0,0 +1,169 @@
+#include "model/mesh_cache.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#include "gtest/gtest.h"
+
+class MeshCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    directory_ = std::filesystem::temp_directory_path() / "3dviewer_cache_test";
+    std::filesystem::remove_all(directory_);
+    source_ = (std::filesystem::temp_directory_path() / "3dviewer_cached.obj")
+                  .string();
+    WriteSource("");
+  }
+
+  void TearDown() override {
+    std::filesystem::remove_all(directory_);
+    std::filesystem::remove(source_);
+  }
+
+  void WriteSource(const std::string &tail) {
+    std::ofstream(source_, std::ios::trunc)
+        << "v 0 0 0\nv 1 0 0\nv 0 1 0\nv 0 0 -2\nvt 0 0\nvt 1 1\n"
+        << "f 1/1 2/2 3/1\nf 1 3 4\n"
+        << tail;
+  }
+
+  s21::LoadOptions CacheOptions() const {
+    s21::LoadOptions options;
+    options.use_cache = true;
+    options.cache_dir = directory_.string();
+    return options;
+  }
+
+  std::filesystem::path directory_;
+  std::string source_;
+};
+
+TEST_F(MeshCacheTest, hash_depends_on_every_byte) {
+  std::string buffer(10 << 20, 'a');
+  std::uint64_t hash = s21::HashContent(buffer, 1);
+  EXPECT_EQ(s21::HashContent(buffer, 4), hash);
+  buffer[7 << 20] = 'b';
+  EXPECT_NE(s21::HashContent(buffer, 1), hash);
+  EXPECT_NE(s21::HashContent("abc"), s21::HashContent("abd"));
+  EXPECT_NE(s21::HashContent(""), s21::HashContent(std::string(1, '\0')));
+}
+
+TEST_F(MeshCacheTest, store_and_fetch_round_trip) {
+  s21::WireframeObject parsed(source_);
+  s21::MeshCache cache(directory_.string());
+  auto key = s21::MeshCache::MakeKey(source_);
+  ASSERT_TRUE(key.has_value());
+  EXPECT_FALSE(cache.Fetch(*key).has_value());
+  ASSERT_TRUE(cache.Store(*key, parsed));
+
+  auto cached = cache.Fetch(*key);
+  ASSERT_TRUE(cached.has_value());
+  EXPECT_GE(cached->GetId(), 0);
+  EXPECT_EQ(cached->GetName(), parsed.GetName());
+  ASSERT_EQ(cached->GetVertexCount(), parsed.GetVertexCount());
+  ASSERT_EQ(cached->GetFaceCount(), parsed.GetFaceCount());
+  EXPECT_EQ(std::memcmp(cached->GetVertices().data(),
+                        parsed.GetVertices().data(),
+                        parsed.GetVertices().size_bytes()),
+            0);
+  EXPECT_EQ(std::memcmp(cached->GetFaces().data(), parsed.GetFaces().data(),
+                        parsed.GetFaces().size_bytes()),
+            0);
+  ASSERT_EQ(cached->GetTextureFaces().size(), 2);
+  EXPECT_EQ(cached->GetTextureFaces()[1].index[0], s21::kNoIndex);
+  EXPECT_TRUE(cached->GetNormalFaces().empty());
+  EXPECT_FLOAT_EQ(cached->GetBounds().min.z, -2.0f);
+  EXPECT_FLOAT_EQ(cached->GetBounds().max.x, 1.0f);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(cached->GetVertices().data()) %
+                s21::kMeshCacheAlignment,
+            0);
+
+  // Copies share the mapping, and it outlives the object it came from
+  s21::WireframeObject copy(*cached);
+  cached.reset();
+  EXPECT_FLOAT_EQ(copy.GetVertices()[1].x, 1.0f);
+}
+
+TEST_F(MeshCacheTest, load_refreshes_stale_entry) {
+  auto first = s21::WireframeObject::Load(source_, CacheOptions());
+  ASSERT_TRUE(first.has_value());
+  EXPECT_EQ(first->GetFaceCount(), 2);
+  auto key = s21::MeshCache::MakeKey(source_);
+  ASSERT_TRUE(key.has_value());
+  EXPECT_TRUE(std::filesystem::exists(
+      s21::MeshCache(directory_.string()).EntryPath(*key)));
+
+  auto second = s21::WireframeObject::Load(source_, CacheOptions());
+  ASSERT_TRUE(second.has_value());
+  EXPECT_EQ(second->GetFaceCount(), 2);
+  EXPECT_NE(second->GetId(), first->GetId());
+
+  WriteSource("f 2 3 4\n");
+  auto changed = s21::WireframeObject::Load(source_, CacheOptions());
+  ASSERT_TRUE(changed.has_value());
+  EXPECT_EQ(changed->GetFaceCount(), 3);
+}
+
+TEST_F(MeshCacheTest, damaged_entry_is_ignored) {
+  s21::WireframeObject parsed(source_);
+  s21::MeshCache cache(directory_.string());
+  auto key = s21::MeshCache::MakeKey(source_);
+  ASSERT_TRUE(key.has_value());
+  ASSERT_TRUE(cache.Store(*key, parsed));
+
+  // Point a face corner past the end of the vertex array
+  std::string entry_path = cache.EntryPath(*key);
+  s21::MeshCacheHeader header;
+  {
+    std::ifstream entry(entry_path, std::ios::binary);
+    entry.read(reinterpret_cast<char *>(&header), sizeof(header));
+  }
+  std::fstream entry(entry_path,
+                     std::ios::binary | std::ios::in | std::ios::out);
+  entry.seekp(header.sections[s21::kSectionFaces].offset);
+  std::uint32_t bad_index = 4;
+  entry.write(reinterpret_cast<const char *>(&bad_index), sizeof(bad_index));
+  entry.close();
+  EXPECT_FALSE(cache.Fetch(*key).has_value());
+
+  std::filesystem::resize_file(entry_path, sizeof(header) / 2);
+  EXPECT_FALSE(cache.Fetch(*key).has_value());
+
+  auto loaded = s21::WireframeObject::Load(source_, CacheOptions());
+  ASSERT_TRUE(loaded.has_value());
+  EXPECT_EQ(loaded->GetFaces()[0].index[0], 0);
+  EXPECT_TRUE(cache.Fetch(*key).has_value());
+}
+
+TEST_F(MeshCacheTest, failed_load_is_not_cached) {
+  std::ofstream(source_, std::ios::trunc) << "v 0 0 0\nf 1 2 3\n";
+  EXPECT_FALSE(s21::WireframeObject::Load(source_, CacheOptions()));
+  EXPECT_FALSE(std::filesystem::exists(directory_) &&
+               !std::filesystem::is_empty(directory_));
+}
+
+TEST_F(MeshCacheTest, entry_keeps_polygon_outlines) {
+  WriteSource("f 1 2 3 4\n");
+  s21::LoadOptions options = CacheOptions();
+  auto parsed = s21::WireframeObject::Load(source_, options);
+  ASSERT_TRUE(parsed.has_value());
+  auto cached = s21::WireframeObject::Load(source_, options);
+  ASSERT_TRUE(cached.has_value());
+  EXPECT_TRUE(cached->GetVertices().data() != parsed->GetVertices().data());
+  ASSERT_EQ(cached->GetFaceEdges().size(), 4);
+  EXPECT_EQ(std::memcmp(cached->GetFaceEdges().data(),
+                        parsed->GetFaceEdges().data(), 4),
+            0);
+  ASSERT_EQ(cached->GetEdges().size(), 5);
+  EXPECT_EQ(std::memcmp(cached->GetEdges().data(), parsed->GetEdges().data(),
+                        cached->GetEdges().size_bytes()),
+            0);
+
+  // An entry built by the fan doesn't serve an ear-clipping load
+  s21::MeshCache cache(directory_.string());
+  auto key = s21::MeshCache::MakeKey(source_);
+  ASSERT_TRUE(key.has_value());
+  key->triangulation = s21::kTriangulateEarClip;
+  EXPECT_FALSE(cache.Fetch(*key).has_value());
+}
@@ -0,0 +1,174 @@
+#include "model/mesh_format.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "model/parser.h"
+
+namespace {
+class MeshFormatTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    std::ofstream clear_log("logs/debug.log", std::ios::trunc);
+  }
+  void TearDown() override {
+    for (const std::string &path : paths_) std::filesystem::remove(path);
+  }
+
+  std::string TempPath(const std::string &name) {
+    paths_.push_back(
+        (std::filesystem::temp_directory_path() / name).string());
+    return paths_.back();
+  }
+
+  template <typename T>
+  static void Append(std::string &bytes, T value) {
+    bytes.append(reinterpret_cast<const char *>(&value), sizeof(T));
+  }
+
+  // Binary STL of the given triangles, nine floats each
+  std::string WriteStl(const std::string &name,
+                       const std::vector<std::vector<float>> &triangles) {
+    std::string bytes(80, ' ');
+    Append<std::uint32_t>(bytes, triangles.size());
+    for (const std::vector<float> &triangle : triangles) {
+      for (int i = 0; i < 3; ++i) Append(bytes, 0.0f);
+      for (float value : triangle) Append(bytes, value);
+      Append<std::uint16_t>(bytes, 0);
+    }
+    return Write(name, bytes);
+  }
+
+  std::string Write(const std::string &name, const std::string &bytes) {
+    std::string path = TempPath(name);
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << bytes;
+    return path;
+  }
+
+  std::string GetLastLogMessage() {
+    std::ifstream log_file("logs/debug.log");
+    std::string line, last_line;
+    while (std::getline(log_file, line)) last_line = line;
+    return last_line;
+  }
+
+ private:
+  std::vector<std::string> paths_;
+};
+
+// A unit square of two triangles sharing an edge, with -0 on one corner
+const std::vector<std::vector<float>> kSquare = {
+    {0, 0, 0, 1, 0, 0, 1, 1, 0}, {-0.0f, 0, 0, 1, 1, 0, 0, 1, 0}};
+
+// Unit square as one quad with normals, a point element and an extra face
+// property to skip
+std::string MakePly(const std::string &format = "binary_little_endian") {
+  std::string bytes =
+      "ply\nformat " + format +
+      " 1.0\ncomment test\nelement vertex 4\nproperty float x\n"
+      "property float y\nproperty double z\nproperty float nx\n"
+      "property float ny\nproperty float nz\nelement face 1\n"
+      "property uchar flags\nproperty list uchar int vertex_indices\n"
+      "element point 2\nproperty list ushort uchar data\nend_header\n";
+  float corners[4][2] = {{0, 0}, {1, 0}, {1, 1}, {0, 1}};
+  auto append = [&bytes](auto value) {
+    bytes.append(reinterpret_cast<const char *>(&value), sizeof(value));
+  };
+  for (auto &corner : corners) {
+    append(corner[0]);
+    append(corner[1]);
+    append(0.0);
+    append(0.0f);
+    append(0.0f);
+    append(1.0f);
+  }
+  append(std::uint8_t{7});
+  append(std::uint8_t{4});
+  for (std::int32_t i : {0, 1, 2, 3}) append(i);
+  for (int i = 0; i < 2; ++i) {
+    append(std::uint16_t{1});
+    append(std::uint8_t{9});
+  }
+  return bytes;
+}
+}  // namespace
+
+TEST_F(MeshFormatTest, detects_formats_by_content_then_extension) {
+  std::string stl = WriteStl("3dviewer_format.bin", kSquare);
+  std::string ply = Write("3dviewer_format.data", MakePly());
+  std::string obj = Write("3dviewer_format.stl.txt", "v 0 0 0\n");
+  std::string named_stl = Write("3dviewer_format.STL", "solid ascii\n");
+  EXPECT_EQ(s21::DetectMeshFormat(stl).format, s21::kFormatStl);
+  EXPECT_EQ(s21::DetectMeshFormat(ply).format, s21::kFormatPly);
+  EXPECT_EQ(s21::DetectMeshFormat(obj).format, s21::kFormatObj);
+  EXPECT_EQ(s21::DetectMeshFormat(named_stl).format, s21::kFormatStl);
+  EXPECT_EQ(s21::DetectMeshFormat("missing.obj.gz").format,
+            s21::kFormatObjGzip);
+  EXPECT_EQ(s21::MeshFormatFilter().find("All models (*.obj *.obj.gz "), 0);
+}
+
+TEST_F(MeshFormatTest, stl_corners_are_welded) {
+  std::string path = WriteStl("3dviewer_square.stl", kSquare);
+  for (unsigned threads : {1u, 4u}) {
+    s21::LoadOptions options;
+    options.thread_count = threads;
+    s21::WireframeObject obj(path, options);
+    EXPECT_EQ(GetLastLogMessage(), "");
+    ASSERT_EQ(obj.GetVertexCount(), 4);
+    ASSERT_EQ(obj.GetFaceCount(), 2);
+    auto faces = obj.GetFaces();
+    EXPECT_EQ(faces[0].index[0], 0);
+    EXPECT_EQ(faces[0].index[2], 2);
+    EXPECT_EQ(faces[1].index[0], 0);
+    EXPECT_EQ(faces[1].index[1], 2);
+    EXPECT_EQ(faces[1].index[2], 3);
+    EXPECT_FALSE(std::signbit(obj.GetVertices()[0].x));
+  }
+}
+
+TEST_F(MeshFormatTest, stl_must_be_binary) {
+  s21::WireframeObject obj(
+      Write("3dviewer_ascii.stl", "solid square\nendsolid square\n"));
+  EXPECT_EQ(obj.GetId(), -1);
+  EXPECT_NE(GetLastLogMessage().find("ASCII STL"), std::string::npos);
+}
+
+TEST_F(MeshFormatTest, ply_quad_is_triangulated_with_normals) {
+  s21::WireframeObject obj(Write("3dviewer_square.ply", MakePly()));
+  EXPECT_EQ(GetLastLogMessage(), "");
+  ASSERT_EQ(obj.GetVertexCount(), 4);
+  ASSERT_EQ(obj.GetFaceCount(), 2);
+  EXPECT_EQ(obj.GetVertices()[2].y, 1.0f);
+  ASSERT_EQ(obj.GetNormals().size(), 4);
+  EXPECT_EQ(obj.GetNormals()[3].z, 1.0f);
+  ASSERT_EQ(obj.GetNormalFaces().size(), 2);
+  EXPECT_EQ(obj.GetNormalFaces()[1].index[2], 3);
+  auto edges = obj.GetFaceEdges();
+  ASSERT_EQ(edges.size(), 2);
+  EXPECT_EQ(edges[0], 0b011);
+  EXPECT_EQ(edges[1], 0b110);
+}
+
+TEST_F(MeshFormatTest, ply_errors_are_reported) {
+  s21::WireframeObject ascii(
+      Write("3dviewer_ascii.ply", MakePly("ascii")));
+  EXPECT_EQ(ascii.GetId(), -1);
+  EXPECT_NE(GetLastLogMessage().find("little-endian"), std::string::npos);
+
+  std::string truncated = MakePly();
+  truncated.resize(truncated.size() - 10);
+  s21::WireframeObject cut(Write("3dviewer_cut.ply", truncated));
+  EXPECT_EQ(cut.GetId(), -1);
+  EXPECT_NE(GetLastLogMessage().find("Invalid face 0"), std::string::npos);
+
+  std::string huge = MakePly();
+  huge.replace(huge.find("vertex 4"), 8, "vertex 18446744073709551615");
+  s21::WireframeObject oversized(Write("3dviewer_huge.ply", huge));
+  EXPECT_EQ(oversized.GetId(), -1);
+  EXPECT_NE(GetLastLogMessage().find("more than the file holds"),
+            std::string::npos);
+}
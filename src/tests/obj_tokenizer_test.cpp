@@ -0,0 +1,66 @@
+#include "model/obj_tokenizer.h"
+
+#include "gtest/gtest.h"
+
+TEST(ObjTokenizerTest, tokens) {
+  s21::ObjTokenizer tokenizer("  vt\t0.5 1\r");
+  EXPECT_EQ(tokenizer.NextToken(), "vt");
+  EXPECT_EQ(tokenizer.NextToken(), "0.5");
+  EXPECT_EQ(tokenizer.NextToken(), "1");
+  EXPECT_EQ(tokenizer.NextToken(), "");
+}
+
+TEST(ObjTokenizerTest, floats) {
+  s21::ObjTokenizer tokenizer("-1.5 +2 3e-2 .25");
+  float value = 0.0f;
+  ASSERT_TRUE(tokenizer.NextFloat(value));
+  EXPECT_FLOAT_EQ(value, -1.5f);
+  ASSERT_TRUE(tokenizer.NextFloat(value));
+  EXPECT_FLOAT_EQ(value, 2.0f);
+  ASSERT_TRUE(tokenizer.NextFloat(value));
+  EXPECT_FLOAT_EQ(value, 0.03f);
+  ASSERT_TRUE(tokenizer.NextFloat(value));
+  EXPECT_FLOAT_EQ(value, 0.25f);
+  EXPECT_FALSE(tokenizer.NextFloat(value));
+}
+
+TEST(ObjTokenizerTest, invalid_floats) {
+  float value = 0.0f;
+  EXPECT_FALSE(s21::ObjTokenizer("1.0abc").NextFloat(value));
+  EXPECT_FALSE(s21::ObjTokenizer("nan").NextFloat(value));
+  EXPECT_FALSE(s21::ObjTokenizer("inf").NextFloat(value));
+  EXPECT_FALSE(s21::ObjTokenizer("1e999").NextFloat(value));
+  EXPECT_FALSE(s21::ObjTokenizer("1,5").NextFloat(value));
+  EXPECT_FALSE(s21::ObjTokenizer("+-1").NextFloat(value));
+  EXPECT_FALSE(s21::ObjTokenizer("++1").NextFloat(value));
+}
+
+TEST(ObjTokenizerTest, face_corners) {
+  s21::ObjTokenizer tokenizer("7 7/8 7//9 7/8/9");
+  s21::FaceCorner corner;
+  ASSERT_TRUE(tokenizer.NextFaceCorner(corner));
+  EXPECT_EQ(corner.v, 7);
+  EXPECT_EQ(corner.vt, 0);
+  EXPECT_EQ(corner.vn, 0);
+  ASSERT_TRUE(tokenizer.NextFaceCorner(corner));
+  EXPECT_EQ(corner.vt, 8);
+  EXPECT_EQ(corner.vn, 0);
+  ASSERT_TRUE(tokenizer.NextFaceCorner(corner));
+  EXPECT_EQ(corner.vt, 0);
+  EXPECT_EQ(corner.vn, 9);
+  ASSERT_TRUE(tokenizer.NextFaceCorner(corner));
+  EXPECT_EQ(corner.v, 7);
+  EXPECT_EQ(corner.vt, 8);
+  EXPECT_EQ(corner.vn, 9);
+  EXPECT_FALSE(tokenizer.NextFaceCorner(corner));
+}
+
+TEST(ObjTokenizerTest, invalid_face_corners) {
+  s21::FaceCorner corner;
+  EXPECT_FALSE(s21::ObjTokenizer("0").NextFaceCorner(corner));
+  EXPECT_FALSE(s21::ObjTokenizer("-1").NextFaceCorner(corner));
+  EXPECT_FALSE(s21::ObjTokenizer("1/").NextFaceCorner(corner));
+  EXPECT_FALSE(s21::ObjTokenizer("1/2/").NextFaceCorner(corner));
+  EXPECT_FALSE(s21::ObjTokenizer("1/2/3/4").NextFaceCorner(corner));
+  EXPECT_FALSE(s21::ObjTokenizer("2/\xD0\x90").NextFaceCorner(corner));
+}
@@ -1,11 +1,24 @@
 #include "model/parser.h"
 
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include <cstring>
+#include <thread>
+
 #include "gtest/gtest.h"
 #include "model/errors.h"
+#include "model/mesh_lod.h"
+#include "model/obj_chunk.h"
 
 class ParserTest : public ::testing::Test {
  protected:
-  void SetUp() override { ClearLogFile(); }
+  // Ids are shared by every test in the binary, start each one from 0
+  void SetUp() override {
+    ClearLogFile();
+    s21::WireframeObject::ResetIdCounter();
+  }
 
   void TearDown() override {}
 
@@ -14,6 +27,47 @@ class ParserTest : public ::testing::Test {
     clear_log.close();
   }
 
+  // Writes a side x side vertex grid split into triangles, big enough to be
+  // parsed in several chunks
+  std::string WriteGridSample(const std::string &name, int side,
+                              const std::string &tail = "") {
+    std::string file_path =
+        (std::filesystem::temp_directory_path() / name).string();
+    std::ofstream file(file_path, std::ios::trunc);
+    for (int y = 0; y < side; ++y) {
+      for (int x = 0; x < side; ++x) {
+        file << "v " << x * 0.01f << ' ' << y * 0.01f << ' ' << x * y * 1e-4f
+             << '\n';
+      }
+    }
+    for (int y = 0; y + 1 < side; ++y) {
+      for (int x = 0; x + 1 < side; ++x) {
+        int a = y * side + x + 1;
+        file << "f " << a << ' ' << a + 1 << ' ' << a + side + 1 << '\n';
+        file << "f " << a << ' ' << a + side + 1 << ' ' << a + side << '\n';
+      }
+    }
+    file << tail;
+    return file_path;
+  }
+
+  // Compresses source into gzip_path as members gzip members, the way
+  // concatenated .gz files look
+  void WriteGzipCopy(const std::string &source, const std::string &gzip_path,
+                     int members = 1) {
+    std::ifstream file(source, std::ios::binary);
+    std::string text((std::istreambuf_iterator<char>(file)),
+                     std::istreambuf_iterator<char>());
+    std::ofstream(gzip_path, std::ios::trunc);
+    for (int i = 0; i < members; ++i) {
+      gzFile gzip = gzopen(gzip_path.c_str(), "ab");
+      std::size_t begin = text.size() * i / members;
+      std::size_t end = text.size() * (i + 1) / members;
+      gzwrite(gzip, text.data() + begin, static_cast<unsigned>(end - begin));
+      gzclose(gzip);
+    }
+  }
+
   std::string GetLastLogMessage() {
     std::ifstream log_file("logs/debug.log");
     std::string last_line;
@@ -105,12 +159,12 @@ TEST_F(ParserTest, corrupt_sample_3) {
 }
 
 TEST_F(ParserTest, corrupt_sample_4) {
+  // No faces: the file loads as a point cloud
   s21::WireframeObject obj("samples/corrupt_sample_4.obj");
-  std::string log_string = GetLastLogMessage();
-  EXPECT_NE(log_string.find("Invalid"), std::string::npos);
-  EXPECT_EQ(obj.GetId(), -1);
-  EXPECT_EQ(obj.GetName(), "");
-  EXPECT_EQ(obj.GetVertices().size(), 0);
+  EXPECT_EQ(GetLastLogMessage(), "");
+  EXPECT_NE(obj.GetId(), -1);
+  EXPECT_TRUE(obj.IsPointCloud());
+  EXPECT_EQ(obj.GetVertices().size(), 3);
   EXPECT_EQ(obj.GetFaces().size(), 0);
 }
 
@@ -164,3 +218,781 @@ TEST_F(ParserTest, assign_name) {
   obj.AssignName("Hi");
   EXPECT_EQ(obj.GetName(), "Hi");
 }
+
+TEST_F(ParserTest, faces_index_parsed_records) {
+  s21::WireframeObject obj("samples/simple.obj");
+  auto vertices = obj.GetVertices();
+  auto faces = obj.GetFaces();
+  ASSERT_EQ(faces.size(), 1);
+  EXPECT_FLOAT_EQ(vertices[faces[0].index[1]].x, 1.0f);
+  EXPECT_FLOAT_EQ(vertices[faces[0].index[2]].z, 1.0f);
+  auto texture_faces = obj.GetTextureFaces();
+  ASSERT_EQ(texture_faces.size(), 1);
+  EXPECT_FLOAT_EQ(obj.GetTextures()[texture_faces[0].index[2]].v, 1.0f);
+  auto normal_faces = obj.GetNormalFaces();
+  ASSERT_EQ(normal_faces.size(), 1);
+  EXPECT_FLOAT_EQ(obj.GetNormals()[normal_faces[0].index[0]].y, 1.0f);
+}
+
+TEST_F(ParserTest, optional_face_attributes) {
+  s21::WireframeObject obj("samples/simple_v.obj");
+  EXPECT_EQ(obj.GetFaces().size(), 1);
+  EXPECT_TRUE(obj.GetTextureFaces().empty());
+  EXPECT_TRUE(obj.GetNormalFaces().empty());
+}
+
+TEST_F(ParserTest, load_without_reservation) {
+  s21::LoadOptions options;
+  options.reserve_by_file_size = false;
+  s21::WireframeObject reserved("samples/tree_sample.obj");
+  s21::WireframeObject unreserved("samples/tree_sample.obj", options);
+  EXPECT_EQ(GetLastLogMessage(), "");
+  EXPECT_EQ(reserved.GetVertices().size(), unreserved.GetVertices().size());
+  EXPECT_EQ(reserved.GetFaces().size(), unreserved.GetFaces().size());
+}
+
+TEST_F(ParserTest, stream_mode_matches_mapped_mode) {
+  s21::LoadOptions options;
+  options.mode = s21::kLoadStream;
+  s21::WireframeObject mapped("samples/tree_sample.obj");
+  s21::WireframeObject streamed("samples/tree_sample.obj", options);
+  EXPECT_EQ(GetLastLogMessage(), "");
+  auto mapped_vertices = mapped.GetVertices();
+  auto streamed_vertices = streamed.GetVertices();
+  ASSERT_EQ(mapped_vertices.size(), streamed_vertices.size());
+  for (size_t i = 0; i < mapped_vertices.size(); i++) {
+    EXPECT_EQ(mapped_vertices[i].x, streamed_vertices[i].x);
+    EXPECT_EQ(mapped_vertices[i].y, streamed_vertices[i].y);
+    EXPECT_EQ(mapped_vertices[i].z, streamed_vertices[i].z);
+  }
+  EXPECT_EQ(mapped.GetFaces().size(), streamed.GetFaces().size());
+}
+
+TEST_F(ParserTest, pipe_falls_back_to_stream) {
+  std::string fifo_path =
+      (std::filesystem::temp_directory_path() / "3dviewer_test.fifo").string();
+  unlink(fifo_path.c_str());
+  ASSERT_EQ(mkfifo(fifo_path.c_str(), 0600), 0);
+  std::thread writer([&fifo_path] {
+    std::ifstream sample("samples/simple_v.obj");
+    std::ofstream fifo(fifo_path);
+    fifo << sample.rdbuf();
+  });
+  s21::WireframeObject obj(fifo_path);
+  writer.join();
+  unlink(fifo_path.c_str());
+  EXPECT_EQ(GetLastLogMessage(), "");
+  EXPECT_NE(obj.GetId(), -1);
+  EXPECT_EQ(obj.GetVertices().size(), 3);
+  EXPECT_EQ(obj.GetFaces().size(), 1);
+}
+
+TEST_F(ParserTest, valid_sample_3) {
+  s21::WireframeObject obj("samples/simple_v_vn.obj");
+  std::string log_string = GetLastLogMessage();
+  EXPECT_EQ(log_string, "");
+  EXPECT_NE(obj.GetId(), -1);
+  ASSERT_EQ(obj.GetFaces().size(), 1);
+  EXPECT_TRUE(obj.GetTextureFaces().empty());
+  auto normal_faces = obj.GetNormalFaces();
+  ASSERT_EQ(normal_faces.size(), 1);
+  EXPECT_EQ(normal_faces[0].index[2], 0);
+}
+
+TEST_F(ParserTest, parallel_matches_serial) {
+  std::string path = WriteGridSample("3dviewer_test_grid.obj", 300);
+  s21::LoadOptions serial_options;
+  serial_options.thread_count = 1;
+  s21::LoadOptions parallel_options;
+  parallel_options.thread_count = 4;
+  s21::WireframeObject serial(path, serial_options);
+  s21::WireframeObject parallel(path, parallel_options);
+  std::filesystem::remove(path);
+  EXPECT_EQ(GetLastLogMessage(), "");
+
+  auto serial_vertices = serial.GetVertices();
+  auto parallel_vertices = parallel.GetVertices();
+  ASSERT_EQ(serial_vertices.size(), 300 * 300);
+  ASSERT_EQ(serial_vertices.size(), parallel_vertices.size());
+  EXPECT_EQ(std::memcmp(serial_vertices.data(), parallel_vertices.data(),
+                        serial_vertices.size() * sizeof(s21::Coordinate)),
+            0);
+
+  auto serial_faces = serial.GetFaces();
+  auto parallel_faces = parallel.GetFaces();
+  ASSERT_EQ(serial_faces.size(), parallel_faces.size());
+  EXPECT_EQ(std::memcmp(serial_faces.data(), parallel_faces.data(),
+                        serial_faces.size() * sizeof(s21::Face)),
+            0);
+}
+
+TEST_F(ParserTest, parallel_reports_forward_reference) {
+  std::string path = WriteGridSample("3dviewer_test_bad_grid.obj", 300,
+                                     "f 1 2 90001\nv 0 0 0\n");
+  s21::LoadOptions options;
+  options.thread_count = 4;
+  s21::WireframeObject obj(path, options);
+  std::filesystem::remove(path);
+  EXPECT_NE(GetLastLogMessage().find("Invalid format in line: f 1 2 90001"),
+            std::string::npos);
+  EXPECT_EQ(obj.GetId(), -1);
+  EXPECT_EQ(obj.GetVertices().size(), 0);
+}
+
+TEST_F(ParserTest, mixed_face_attributes) {
+  std::string path =
+      (std::filesystem::temp_directory_path() / "3dviewer_mixed.obj").string();
+  std::ofstream(path) << "v 0 0 0\nv 1 0 0\nv 0 1 0\nvt 0 0\n"
+                      << "f 1 2 3\nf 1/1 2/1 3\n";
+  s21::WireframeObject obj(path);
+  std::filesystem::remove(path);
+  auto texture_faces = obj.GetTextureFaces();
+  ASSERT_EQ(texture_faces.size(), 2);
+  EXPECT_EQ(texture_faces[0].index[0], s21::kNoIndex);
+  EXPECT_EQ(texture_faces[1].index[0], 0);
+  EXPECT_EQ(texture_faces[1].index[2], s21::kNoIndex);
+  EXPECT_TRUE(obj.GetNormalFaces().empty());
+}
+
+TEST_F(ParserTest, accessors_view_model_storage) {
+  s21::WireframeObject obj("samples/simple.obj");
+  ASSERT_GT(obj.GetVertexCount(), 0);
+  EXPECT_EQ(obj.GetVertices().data(), obj.GetVertices().data());
+  EXPECT_EQ(obj.GetFaces().data(), obj.GetFaces().data());
+  EXPECT_EQ(obj.GetVertexCount(), obj.GetVertices().size());
+  EXPECT_EQ(obj.GetFaceCount(), obj.GetFaces().size());
+  EXPECT_EQ(obj.GetNormalCount(), obj.GetNormals().size());
+  EXPECT_EQ(obj.GetTextureCount(), obj.GetTextures().size());
+  s21::WireframeObject copy(obj);
+  EXPECT_NE(copy.GetVertices().data(), obj.GetVertices().data());
+  EXPECT_EQ(copy.GetVertexCount(), obj.GetVertexCount());
+}
+
+TEST_F(ParserTest, move_keeps_mesh_and_id) {
+  s21::WireframeObject obj("samples/simple.obj");
+  const s21::Coordinate *vertices = obj.GetVertices().data();
+  std::size_t vertex_count = obj.GetVertexCount();
+  int id = obj.GetId();
+  s21::WireframeObject moved(std::move(obj));
+  EXPECT_EQ(moved.GetId(), id);
+  EXPECT_EQ(moved.GetVertices().data(), vertices);
+  EXPECT_EQ(moved.GetVertexCount(), vertex_count);
+  EXPECT_EQ(obj.GetId(), -1);
+  EXPECT_EQ(obj.GetVertexCount(), 0);
+
+  s21::WireframeObject assigned("samples/empty.obj");
+  assigned = std::move(moved);
+  EXPECT_EQ(assigned.GetId(), id);
+  EXPECT_EQ(assigned.GetVertices().data(), vertices);
+  EXPECT_EQ(moved.GetFaceCount(), 0);
+}
+
+TEST_F(ParserTest, load_factory) {
+  auto model = s21::WireframeObject::Load("samples/simple.obj");
+  ASSERT_TRUE(model.has_value());
+  EXPECT_GE(model->GetId(), 0);
+  EXPECT_GT(model->GetFaceCount(), 0);
+  EXPECT_FALSE(s21::WireframeObject::Load("samples/non_existent.obj"));
+  EXPECT_FALSE(s21::WireframeObject::Load("samples/corrupt_sample_0.obj"));
+}
+
+TEST_F(ParserTest, progress_counts_whole_file) {
+  std::string path = WriteGridSample("3dviewer_progress.obj", 300);
+  std::uintmax_t file_size = std::filesystem::file_size(path);
+  for (s21::LoadModeT mode : {s21::kLoadMapped, s21::kLoadStream}) {
+    for (unsigned threads : {1u, 4u}) {
+      s21::LoadProgress progress;
+      s21::LoadOptions options;
+      options.mode = mode;
+      options.thread_count = threads;
+      options.progress = &progress;
+      s21::WireframeObject obj(path, options);
+      EXPECT_EQ(progress.GetTotalBytes(), file_size);
+      EXPECT_EQ(progress.GetBytesProcessed(), file_size);
+      EXPECT_EQ(progress.GetRecordsParsed(),
+                obj.GetVertexCount() + obj.GetFaceCount());
+    }
+  }
+  std::filesystem::remove(path);
+}
+
+TEST_F(ParserTest, cancelled_load_is_empty) {
+  std::string path = WriteGridSample("3dviewer_cancel.obj", 300);
+  for (s21::LoadModeT mode : {s21::kLoadMapped, s21::kLoadStream}) {
+    for (unsigned threads : {1u, 4u}) {
+      s21::LoadProgress progress;
+      progress.Cancel();
+      s21::LoadOptions options;
+      options.mode = mode;
+      options.thread_count = threads;
+      options.progress = &progress;
+      EXPECT_FALSE(s21::WireframeObject::Load(path, options).has_value());
+      EXPECT_LT(progress.GetBytesProcessed(), std::filesystem::file_size(path));
+    }
+  }
+  // Cancelling is not an error
+  EXPECT_EQ(GetLastLogMessage(), "");
+  std::filesystem::remove(path);
+}
+
+TEST_F(ParserTest, stream_publishes_model_prefix) {
+  std::string path = WriteGridSample("3dviewer_stream.obj", 300);
+  for (s21::LoadModeT mode : {s21::kLoadMapped, s21::kLoadStream}) {
+    for (unsigned threads : {1u, 4u}) {
+      s21::MeshStream stream;
+      s21::LoadOptions options;
+      options.mode = mode;
+      options.thread_count = threads;
+      options.stream = &stream;
+      s21::WireframeObject obj(path, options);
+      std::vector<s21::MeshBatch> batches = stream.TakeBatches();
+      EXPECT_GT(batches.size(), 1);
+      std::vector<s21::Coordinate> vertices;
+      std::vector<s21::Face> faces;
+      for (const s21::MeshBatch &batch : batches) {
+        vertices.insert(vertices.end(), batch.vertices.begin(),
+                        batch.vertices.end());
+        faces.insert(faces.end(), batch.faces.begin(), batch.faces.end());
+      }
+      ASSERT_EQ(vertices.size(), obj.GetVertexCount());
+      ASSERT_EQ(faces.size(), obj.GetFaceCount());
+      EXPECT_EQ(std::memcmp(vertices.data(), obj.GetVertices().data(),
+                            obj.GetVertices().size_bytes()),
+                0);
+      EXPECT_EQ(std::memcmp(faces.data(), obj.GetFaces().data(),
+                            obj.GetFaces().size_bytes()),
+                0);
+      EXPECT_TRUE(stream.TakeBatches().empty());
+    }
+  }
+  std::filesystem::remove(path);
+}
+
+TEST_F(ParserTest, stream_stops_before_invalid_records) {
+  std::string path =
+      WriteGridSample("3dviewer_stream_bad.obj", 300, "f 1 2 90001\n");
+  for (unsigned threads : {1u, 4u}) {
+    s21::MeshStream stream;
+    s21::LoadOptions options;
+    options.thread_count = threads;
+    options.stream = &stream;
+    EXPECT_FALSE(s21::WireframeObject::Load(path, options).has_value());
+    std::size_t vertex_count = stream.GetPublishedVertexCount();
+    for (const s21::MeshBatch &batch : stream.TakeBatches()) {
+      for (const s21::Face &face : batch.faces) {
+        for (std::uint32_t index : face.index) EXPECT_LT(index, vertex_count);
+      }
+    }
+  }
+  std::filesystem::remove(path);
+}
+
+TEST_F(ParserTest, parallel_for_rethrows_task_exceptions) {
+  for (unsigned threads : {1u, 4u}) {
+    std::atomic<std::size_t> done{0};
+    EXPECT_THROW(s21::ParallelFor(1000, threads,
+                                  [&](std::size_t i) {
+                                    if (i == 10) throw std::bad_alloc();
+                                    ++done;
+                                  }),
+                 std::bad_alloc);
+    EXPECT_LT(done.load(), 1000);
+  }
+}
+
+TEST_F(ParserTest, chunk_widens_past_narrow_limit) {
+  s21::ObjChunk chunk(false, 3);
+  std::string buffer =
+      "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 3\nv 1 1 0\nf 2 4 3\n";
+  ASSERT_EQ(chunk.Parse(buffer), s21::success_code);
+  EXPECT_EQ(chunk.GetIndexWidth(), s21::kIndex64);
+  EXPECT_TRUE(chunk.faces_.empty());
+  ASSERT_EQ(chunk.wide_faces_.size(), 2);
+  EXPECT_EQ(chunk.wide_faces_[0].index[2], 2u);
+  EXPECT_EQ(chunk.wide_faces_[1].index[1], 3u);
+}
+
+class MergeProbe : public s21::WireframeObject {
+ public:
+  using s21::WireframeObject::WireframeObject;
+  void Merge(std::vector<s21::ObjChunk> &chunks) {
+    Clear();
+    MergeChunks(chunks, 2, nullptr);
+  }
+};
+
+TEST_F(ParserTest, wide_chunk_widens_merged_mesh) {
+  std::vector<s21::ObjChunk> chunks;
+  chunks.emplace_back(true);
+  chunks.emplace_back(true, 3);
+  ASSERT_EQ(chunks[0].Parse("v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 3\n"),
+            s21::success_code);
+  ASSERT_EQ(chunks[1].Parse("v 1 1 0\nf 2 4 3\n"), s21::success_code);
+  ASSERT_EQ(chunks[1].GetIndexWidth(), s21::kIndex64);
+
+  MergeProbe obj("samples/simple.obj");
+  obj.Merge(chunks);
+  EXPECT_EQ(obj.GetIndexWidth(), s21::kIndex64);
+  EXPECT_TRUE(obj.GetFaces().empty());
+  EXPECT_EQ(obj.GetVertexCount(), 4);
+  ASSERT_EQ(obj.GetFaceCount(), 2);
+  EXPECT_EQ(obj.GetWideFaces()[0].index[1], 1u);
+  EXPECT_EQ(obj.GetWideFaces()[1].index[1], 3u);
+}
+
+TEST_F(ParserTest, memory_budget_rejects_large_model) {
+  std::string path = WriteGridSample("3dviewer_budget.obj", 300);
+  for (s21::LoadModeT mode : {s21::kLoadMapped, s21::kLoadStream}) {
+    for (unsigned threads : {1u, 4u}) {
+      ClearLogFile();
+      s21::LoadOptions options;
+      options.mode = mode;
+      options.thread_count = threads;
+      options.memory_budget = 64 << 10;
+      EXPECT_FALSE(s21::WireframeObject::Load(path, options).has_value());
+      std::ifstream log_file("logs/debug.log");
+      std::string log((std::istreambuf_iterator<char>(log_file)),
+                      std::istreambuf_iterator<char>());
+      EXPECT_NE(log.find("memory budget"), std::string::npos);
+    }
+  }
+  std::filesystem::remove(path);
+}
+
+TEST_F(ParserTest, loads_past_former_vertex_limit) {
+  // The parser used to refuse models with more than 1.5M vertices
+  constexpr std::size_t kVertexCount = 1600000;
+  std::string path =
+      (std::filesystem::temp_directory_path() / "3dviewer_many.obj").string();
+  {
+    std::ofstream file(path, std::ios::trunc);
+    for (std::size_t i = 0; i < kVertexCount; ++i) file << "v 0 0 0\n";
+    file << "f 1 2 " << kVertexCount << '\n';
+  }
+  for (unsigned threads : {1u, 4u}) {
+    s21::LoadOptions options;
+    options.thread_count = threads;
+    std::optional<s21::WireframeObject> obj =
+        s21::WireframeObject::Load(path, options);
+    ASSERT_TRUE(obj.has_value());
+    EXPECT_EQ(obj->GetVertexCount(), kVertexCount);
+    EXPECT_EQ(obj->GetIndexWidth(), s21::kIndex32);
+    EXPECT_EQ(obj->GetFaces()[0].index[2], kVertexCount - 1);
+  }
+  std::filesystem::remove(path);
+}
+
+TEST_F(ParserTest, vertex_only_file_loads_as_point_cloud) {
+  constexpr int kPointCount = 200000;
+  std::string path =
+      (std::filesystem::temp_directory_path() / "3dviewer_cloud.obj").string();
+  {
+    std::ofstream file(path, std::ios::trunc);
+    for (int i = 0; i < kPointCount; ++i) {
+      file << "v " << i * 1e-3f << " 0 " << -i * 1e-3f << '\n';
+    }
+  }
+  for (s21::LoadModeT mode : {s21::kLoadMapped, s21::kLoadStream}) {
+    for (unsigned threads : {1u, 4u}) {
+      s21::LoadOptions options;
+      options.mode = mode;
+      options.thread_count = threads;
+      std::optional<s21::WireframeObject> obj =
+          s21::WireframeObject::Load(path, options);
+      ASSERT_TRUE(obj.has_value());
+      EXPECT_TRUE(obj->IsPointCloud());
+      EXPECT_EQ(obj->GetVertexCount(), kPointCount);
+      EXPECT_EQ(obj->GetFaceCount(), 0);
+      EXPECT_FLOAT_EQ(obj->GetVertices()[kPointCount - 1].x,
+                      (kPointCount - 1) * 1e-3f);
+      EXPECT_FLOAT_EQ(obj->GetBounds().min.z, -(kPointCount - 1) * 1e-3f);
+    }
+  }
+  std::filesystem::remove(path);
+}
+
+TEST_F(ParserTest, polygon_is_fanned_with_outline) {
+  std::string path =
+      (std::filesystem::temp_directory_path() / "3dviewer_quad.obj").string();
+  std::ofstream(path, std::ios::trunc)
+      << "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\nv 2 0 0\n"
+      << "f 1 2 5\nf 1 2 3 4 # quad\n";
+  s21::WireframeObject obj(path);
+  ASSERT_EQ(obj.GetFaceCount(), 3);
+  EXPECT_EQ(obj.GetFaces()[1].index[2], 2u);
+  EXPECT_EQ(obj.GetFaces()[2].index[0], 0u);
+  EXPECT_EQ(obj.GetFaces()[2].index[1], 2u);
+  EXPECT_EQ(obj.GetFaces()[2].index[2], 3u);
+  // The diagonal 1-3 belongs to neither outline
+  ASSERT_EQ(obj.GetFaceEdges().size(), 3);
+  EXPECT_EQ(obj.GetFaceEdges()[0], s21::kAllFaceEdges);
+  EXPECT_EQ(obj.GetFaceEdges()[1], 0b011);
+  EXPECT_EQ(obj.GetFaceEdges()[2], 0b110);
+  // Edge 1-2 of both faces is listed once, the diagonal not at all
+  std::vector<std::pair<std::uint32_t, std::uint32_t>> edges;
+  for (const s21::Edge &edge : obj.GetEdges()) {
+    edges.emplace_back(edge.index[0], edge.index[1]);
+  }
+  std::vector<std::pair<std::uint32_t, std::uint32_t>> expected = {
+      {0, 1}, {0, 3}, {0, 4}, {1, 2}, {1, 4}, {2, 3}};
+  EXPECT_EQ(edges, expected);
+  std::filesystem::remove(path);
+}
+
+TEST_F(ParserTest, ear_clipping_cuts_concave_polygon) {
+  std::string path =
+      (std::filesystem::temp_directory_path() / "3dviewer_dart.obj").string();
+  // Corner 4 points inwards: the fan from corner 1 folds over it
+  std::ofstream(path, std::ios::trunc)
+      << "v 0 0 0\nv 4 0 0\nv 4 4 0\nv 2 1 0\nv 0 4 0\n"
+      << "vt 0 0\nvt 1 0\nvt 1 1\nvt 0.5 0.25\nvt 0 1\n"
+      << "f 1/1 2/2 3/3 4/4 5/5\n";
+  s21::LoadOptions options;
+  options.triangulation = s21::kTriangulateEarClip;
+  s21::WireframeObject obj(path, options);
+  ASSERT_EQ(obj.GetFaceCount(), 3);
+  float area = 0.0f;
+  int outline_edges = 0;
+  for (std::size_t i = 0; i < obj.GetFaceCount(); ++i) {
+    const s21::Face &face = obj.GetFaces()[i];
+    const s21::Coordinate &a = obj.GetVertices()[face.index[0]];
+    const s21::Coordinate &b = obj.GetVertices()[face.index[1]];
+    const s21::Coordinate &c = obj.GetVertices()[face.index[2]];
+    float twice_area = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+    EXPECT_GT(twice_area, 0.0f);
+    area += twice_area / 2;
+    for (int k = 0; k < 3; ++k) {
+      EXPECT_EQ(obj.GetTextureFaces()[i].index[k], face.index[k]);
+      outline_edges += (obj.GetFaceEdges()[i] >> k) & 1;
+    }
+  }
+  EXPECT_FLOAT_EQ(area, 10.0f);
+  EXPECT_EQ(outline_edges, 5);
+  std::filesystem::remove(path);
+}
+
+TEST_F(ParserTest, merged_chunks_keep_polygons) {
+  std::vector<s21::ObjChunk> chunks;
+  chunks.emplace_back(true);
+  chunks.emplace_back(true);
+  for (s21::ObjChunk &chunk : chunks) {
+    chunk.SetTriangulation(s21::kTriangulateEarClip);
+  }
+  ASSERT_EQ(chunks[0].Parse("v 0 0 0\nv 4 0 0\nv 4 4 0\nf 1 2 3\n"),
+            s21::success_code);
+  ASSERT_EQ(chunks[1].Parse("v 2 1 0\nv 0 4 0\nf 1 2 3 4 5\n"),
+            s21::success_code);
+  EXPECT_TRUE(chunks[0].face_edges_.empty());
+  ASSERT_EQ(chunks[1].polygons_.size(), 1);
+
+  MergeProbe obj("samples/simple.obj");
+  obj.Merge(chunks);
+  ASSERT_EQ(obj.GetFaceCount(), 4);
+  ASSERT_EQ(obj.GetFaceEdges().size(), 4);
+  EXPECT_EQ(obj.GetFaceEdges()[0], s21::kAllFaceEdges);
+  // Ear clipping fixed the fan triangle (1, 3, 4) that folds over corner 4
+  for (std::size_t i = 1; i < 4; ++i) {
+    const s21::Face &face = obj.GetFaces()[i];
+    const s21::Coordinate &a = obj.GetVertices()[face.index[0]];
+    const s21::Coordinate &b = obj.GetVertices()[face.index[1]];
+    const s21::Coordinate &c = obj.GetVertices()[face.index[2]];
+    EXPECT_GT((b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x), 0.0f);
+  }
+}
+
+class ArenaProbe : public s21::WireframeObject {
+ public:
+  using s21::WireframeObject::WireframeObject;
+  ArenaProbe(const s21::WireframeObject &other) : WireframeObject(other) {}
+  const s21::Arena *GetArena() const { return arena_.get(); }
+};
+
+TEST_F(ParserTest, contiguous_mesh_lives_in_arena) {
+  std::string path = WriteGridSample("3dviewer_arena.obj", 300);
+  s21::WireframeObject reference(path);
+  for (s21::LoadModeT mode : {s21::kLoadMapped, s21::kLoadStream}) {
+    for (unsigned threads : {1u, 4u}) {
+      s21::LoadOptions options;
+      options.mode = mode;
+      options.thread_count = threads;
+      auto obj = std::make_unique<ArenaProbe>(path, options);
+      ASSERT_NE(obj->GetArena(), nullptr);
+      EXPECT_TRUE(obj->GetArena()->Contains(obj->GetVertices().data()));
+      EXPECT_TRUE(obj->GetArena()->Contains(obj->GetFaces().data()));
+
+      // A copy is independent of the arena it was made from
+      ArenaProbe copy(*obj);
+      obj.reset();
+      EXPECT_EQ(copy.GetArena(), nullptr);
+      ASSERT_EQ(copy.GetFaceCount(), reference.GetFaceCount());
+      EXPECT_EQ(std::memcmp(copy.GetFaces().data(),
+                            reference.GetFaces().data(),
+                            reference.GetFaces().size_bytes()),
+                0);
+
+      options.contiguous_mesh = false;
+      ArenaProbe heap(path, options);
+      EXPECT_EQ(heap.GetArena(), nullptr);
+      EXPECT_EQ(heap.GetVertexCount(), reference.GetVertexCount());
+    }
+  }
+  std::filesystem::remove(path);
+}
+
+TEST_F(ParserTest, gzip_file_matches_plain_file) {
+  std::string path = WriteGridSample("3dviewer_test_gzip.obj", 400);
+  std::string gzip_path = path + ".gz";
+  s21::WireframeObject plain(path);
+  std::uintmax_t file_size = std::filesystem::file_size(path);
+  // Splitting the text mid-line also covers lines across members
+  for (int members : {1, 3}) {
+    WriteGzipCopy(path, gzip_path, members);
+    s21::LoadProgress progress;
+    s21::LoadOptions options;
+    options.progress = &progress;
+    s21::WireframeObject gzip(gzip_path, options);
+    EXPECT_EQ(GetLastLogMessage(), "");
+    EXPECT_GE(gzip.GetId(), 0);
+    EXPECT_EQ(progress.GetBytesProcessed(), file_size);
+    if (members == 1) {
+      EXPECT_EQ(progress.GetTotalBytes(), file_size);
+    }
+
+    auto vertices = gzip.GetVertices();
+    ASSERT_EQ(vertices.size(), plain.GetVertices().size());
+    EXPECT_EQ(std::memcmp(vertices.data(), plain.GetVertices().data(),
+                          vertices.size() * sizeof(s21::Coordinate)),
+              0);
+    auto faces = gzip.GetFaces();
+    ASSERT_EQ(faces.size(), plain.GetFaces().size());
+    EXPECT_EQ(std::memcmp(faces.data(), plain.GetFaces().data(),
+                          faces.size() * sizeof(s21::Face)),
+              0);
+  }
+  std::filesystem::remove(path);
+  std::filesystem::remove(gzip_path);
+}
+
+TEST_F(ParserTest, truncated_gzip_is_rejected) {
+  std::string path = WriteGridSample("3dviewer_test_truncated.obj", 300);
+  std::string gzip_path = path + ".gz";
+  WriteGzipCopy(path, gzip_path);
+  std::filesystem::resize_file(gzip_path,
+                               std::filesystem::file_size(gzip_path) / 2);
+  s21::WireframeObject obj(gzip_path);
+  std::filesystem::remove(path);
+  std::filesystem::remove(gzip_path);
+  EXPECT_NE(GetLastLogMessage().find("ParseGzip"), std::string::npos);
+  EXPECT_EQ(obj.GetId(), -1);
+  EXPECT_EQ(obj.GetVertices().size(), 0);
+}
+
+TEST_F(ParserTest, weld_joins_duplicated_corners) {
+  // The grid written as a triangle soup, three own vertices per face
+  s21::WireframeObject grid(WriteGridSample("3dviewer_weld_grid.obj", 150));
+  std::string soup_path =
+      (std::filesystem::temp_directory_path() / "3dviewer_soup.obj").string();
+  std::ofstream soup(soup_path, std::ios::trunc);
+  soup.precision(9);
+  for (const s21::Face &face : grid.GetFaces()) {
+    for (std::uint32_t index : face.index) {
+      const s21::Coordinate &v = grid.GetVertices()[index];
+      soup << "v " << v.x << ' ' << v.y << ' ' << v.z << '\n';
+    }
+  }
+  for (std::size_t i = 0; i < grid.GetFaceCount(); ++i) {
+    soup << "f " << 3 * i + 1 << ' ' << 3 * i + 2 << ' ' << 3 * i + 3 << '\n';
+  }
+  soup.close();
+
+  std::vector<s21::Face> reference;
+  for (unsigned threads : {1u, 4u}) {
+    s21::LoadOptions options;
+    options.thread_count = threads;
+    options.weld_tolerance = 0.0f;
+    auto welded = s21::WireframeObject::Load(soup_path, options);
+    ASSERT_TRUE(welded);
+    ASSERT_TRUE(welded->GetWeldStats());
+    EXPECT_EQ(welded->GetWeldStats()->vertices_before,
+              grid.GetFaceCount() * 3);
+    EXPECT_EQ(welded->GetWeldStats()->vertices_after, grid.GetVertexCount());
+    ASSERT_EQ(welded->GetVertexCount(), grid.GetVertexCount());
+    ASSERT_EQ(welded->GetFaceCount(), grid.GetFaceCount());
+    for (std::size_t i = 0; i < grid.GetFaceCount(); ++i) {
+      for (int k = 0; k < 3; ++k) {
+        const s21::Coordinate &a =
+            welded->GetVertices()[welded->GetFaces()[i].index[k]];
+        const s21::Coordinate &b =
+            grid.GetVertices()[grid.GetFaces()[i].index[k]];
+        ASSERT_EQ(a.x, b.x);
+        ASSERT_EQ(a.y, b.y);
+        ASSERT_EQ(a.z, b.z);
+      }
+    }
+    auto faces = welded->GetFaces();
+    if (reference.empty()) reference.assign(faces.begin(), faces.end());
+    EXPECT_EQ(std::memcmp(faces.data(), reference.data(), faces.size_bytes()),
+              0);
+  }
+  std::filesystem::remove(soup_path);
+}
+
+TEST_F(ParserTest, weld_after_stream_drops_streamed_prefix) {
+  // The last vertex repeats the first one
+  std::string duplicated = WriteGridSample("3dviewer_weld_stream.obj", 200,
+                                           "v 0 0 0\nf 1 2 40001\n");
+  std::string unique = WriteGridSample("3dviewer_weld_unique.obj", 200);
+  for (const std::string &path : {duplicated, unique}) {
+    for (float tolerance : {-1.0f, 0.0f}) {
+      s21::MeshStream stream;
+      s21::LoadOptions options;
+      options.thread_count = 4;
+      options.stream = &stream;
+      options.weld_tolerance = tolerance;
+      auto obj = s21::WireframeObject::Load(path, options);
+      ASSERT_TRUE(obj);
+      std::vector<s21::Coordinate> vertices;
+      std::vector<s21::Face> faces;
+      for (const s21::MeshBatch &batch : stream.TakeBatches()) {
+        vertices.insert(vertices.end(), batch.vertices.begin(),
+                        batch.vertices.end());
+        faces.insert(faces.end(), batch.faces.begin(), batch.faces.end());
+      }
+      bool merged = path == duplicated && tolerance >= 0;
+      EXPECT_EQ(obj->KeepsStreamedPrefix(), !merged);
+      if (merged) {
+        EXPECT_EQ(obj->GetVertexCount() + 1, vertices.size());
+        EXPECT_EQ(obj->GetFaces().back().index[2], 0u);
+        continue;
+      }
+      ASSERT_EQ(vertices.size(), obj->GetVertexCount());
+      ASSERT_EQ(faces.size(), obj->GetFaceCount());
+      EXPECT_EQ(std::memcmp(vertices.data(), obj->GetVertices().data(),
+                            obj->GetVertices().size_bytes()),
+                0);
+      EXPECT_EQ(std::memcmp(faces.data(), obj->GetFaces().data(),
+                            obj->GetFaces().size_bytes()),
+                0);
+    }
+  }
+  std::filesystem::remove(duplicated);
+  std::filesystem::remove(unique);
+}
+
+TEST_F(ParserTest, weld_tolerance_joins_close_vertices) {
+  std::string path =
+      (std::filesystem::temp_directory_path() / "3dviewer_close.obj").string();
+  std::ofstream(path, std::ios::trunc)
+      << "v 0 0 0\nv 1 0 0\nv 0 1 0\nv -0 1e-7 0\nv 1 0 1e-6\nv 0 1 0\n"
+         "f 1 2 3\nf 4 5 6\n";
+
+  s21::WireframeObject exact(path);
+  EXPECT_FALSE(exact.GetWeldStats());
+  exact.WeldVertices(0.0f);
+  EXPECT_EQ(exact.GetVertexCount(), 5);
+  EXPECT_EQ(exact.GetFaces()[1].index[2], 2);
+
+  s21::WireframeObject close(path);
+  s21::WeldStats stats = close.WeldVertices(1e-5f, 4);
+  EXPECT_EQ(stats.vertices_before, 6);
+  EXPECT_EQ(stats.vertices_after, 3);
+  EXPECT_GE(stats.milliseconds, 0.0);
+  ASSERT_EQ(close.GetVertexCount(), 3);
+  for (int k = 0; k < 3; ++k) {
+    EXPECT_EQ(close.GetFaces()[1].index[k], close.GetFaces()[0].index[k]);
+  }
+  EXPECT_EQ(close.GetBounds().max.z, 0.0f);
+  std::filesystem::remove(path);
+}
+
+TEST_F(ParserTest, grid_edges_are_listed_once) {
+  const std::size_t side = 120;
+  std::string path = WriteGridSample("3dviewer_edges.obj", side);
+  std::vector<s21::Edge> reference;
+  for (unsigned threads : {1u, 4u}) {
+    s21::LoadOptions options;
+    options.thread_count = threads;
+    s21::WireframeObject obj(path, options);
+    auto edges = obj.GetEdges();
+    // Rows, columns and one diagonal per cell
+    ASSERT_EQ(edges.size(),
+              2 * side * (side - 1) + (side - 1) * (side - 1));
+    for (std::size_t i = 0; i < edges.size(); ++i) {
+      ASSERT_LT(edges[i].index[0], edges[i].index[1]);
+      if (i > 0) {
+        ASSERT_TRUE(edges[i - 1].index[0] < edges[i].index[0] ||
+                    (edges[i - 1].index[0] == edges[i].index[0] &&
+                     edges[i - 1].index[1] < edges[i].index[1]));
+      }
+    }
+    if (reference.empty()) reference.assign(edges.begin(), edges.end());
+    EXPECT_EQ(std::memcmp(edges.data(), reference.data(), edges.size_bytes()),
+              0);
+  }
+  std::filesystem::remove(path);
+}
+
+TEST_F(ParserTest, clustered_grid_keeps_valid_faces) {
+  std::string path = WriteGridSample("3dviewer_cluster.obj", 120);
+  s21::WireframeObject obj(path);
+  std::vector<s21::Coordinate> reference;
+  for (unsigned threads : {1u, 4u}) {
+    s21::MeshLod lod =
+        s21::ClusterVertices(obj.GetVertices(), obj.GetFaces(),
+                             obj.GetFaceEdges(), obj.GetBounds(), 16, threads);
+    EXPECT_EQ(lod.grid_cells, 16);
+    ASSERT_GT(lod.vertices.size(), 0);
+    EXPECT_LT(lod.vertices.size(), obj.GetVertexCount() / 8);
+    ASSERT_GT(lod.faces.size(), 0);
+    EXPECT_LT(lod.faces.size(), obj.GetFaceCount() / 8);
+    for (const s21::Face &face : lod.faces) {
+      for (int k = 0; k < 3; ++k) {
+        ASSERT_LT(face.index[k], lod.vertices.size());
+        ASSERT_NE(face.index[k], face.index[(k + 1) % 3]);
+      }
+    }
+    for (const s21::Coordinate &vertex : lod.vertices) {
+      EXPECT_GE(vertex.x, obj.GetBounds().min.x);
+      EXPECT_LE(vertex.z, obj.GetBounds().max.z);
+    }
+    ASSERT_GT(lod.edges.size(), 0);
+    for (const s21::Edge &edge : lod.edges) {
+      ASSERT_LT(edge.index[0], edge.index[1]);
+    }
+    if (reference.empty()) reference = lod.vertices;
+    ASSERT_EQ(lod.vertices.size(), reference.size());
+    EXPECT_EQ(std::memcmp(lod.vertices.data(), reference.data(),
+                          reference.size() * sizeof(s21::Coordinate)),
+              0);
+  }
+  // Too small to need coarser levels
+  EXPECT_TRUE(s21::BuildLodChain(obj, 0).empty());
+  std::filesystem::remove(path);
+}
+
+TEST_F(ParserTest, lod_chain_levels_shrink) {
+  std::string path = WriteGridSample("3dviewer_lod.obj", 260);
+  s21::WireframeObject obj(path);
+  ASSERT_GE(obj.GetFaceCount(), s21::kLodMinFaces);
+  std::vector<s21::MeshLod> chain = s21::BuildLodChain(obj, 0);
+  ASSERT_FALSE(chain.empty());
+  std::size_t faces = obj.GetFaceCount();
+  unsigned grid_cells = UINT_MAX;
+  for (const s21::MeshLod &lod : chain) {
+    EXPECT_LE(lod.faces.size(), faces / 2);
+    EXPECT_LT(lod.grid_cells, grid_cells);
+    EXPECT_GE(lod.grid_cells, s21::kLodMinGridCells);
+    EXPECT_GE(lod.milliseconds, 0.0);
+    faces = lod.faces.size();
+    grid_cells = lod.grid_cells;
+  }
+
+  std::atomic<bool> cancel{true};
+  EXPECT_TRUE(s21::BuildLodChain(obj, 0, &cancel).empty());
+  s21::MeshLod cancelled =
+      s21::ClusterVertices(obj.GetVertices(), obj.GetFaces(),
+                           obj.GetFaceEdges(), obj.GetBounds(), 16, 4, &cancel);
+  EXPECT_TRUE(cancelled.vertices.empty());
+  EXPECT_TRUE(cancelled.edges.empty());
+  std::filesystem::remove(path);
+}
@@ -0,0 +1,66 @@
+#include "model/simd_scanner.h"
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+std::vector<std::string_view> SplitWithScanner(std::string_view buffer) {
+  std::vector<std::string_view> lines;
+  s21::LineScanner scanner(buffer);
+  std::string_view line;
+  while (scanner.Next(line)) lines.push_back(line);
+  return lines;
+}
+
+std::vector<std::string_view> SplitWithFind(std::string_view buffer) {
+  std::vector<std::string_view> lines;
+  while (!buffer.empty()) {
+    size_t line_end = buffer.find('\n');
+    lines.push_back(buffer.substr(0, line_end));
+    buffer.remove_prefix(line_end == std::string_view::npos ? buffer.size()
+                                                            : line_end + 1);
+  }
+  return lines;
+}
+
+}  // namespace
+
+TEST(LineScannerTest, empty) {
+  EXPECT_TRUE(SplitWithScanner("").empty());
+  EXPECT_EQ(SplitWithScanner("\n").size(), 1);
+}
+
+TEST(LineScannerTest, last_line_without_newline) {
+  auto lines = SplitWithScanner("v 1 2 3\r\nf 1 1 1");
+  ASSERT_EQ(lines.size(), 2);
+  EXPECT_EQ(lines[0], "v 1 2 3\r");
+  EXPECT_EQ(lines[1], "f 1 1 1");
+}
+
+TEST(LineScannerTest, matches_find_across_block_sizes) {
+  // Line lengths around the 64-byte block size and its multiples
+  for (size_t line_size : {0, 1, 15, 31, 63, 64, 65, 127, 200}) {
+    for (size_t total : {1, 63, 64, 65, 129, 1000}) {
+      std::string buffer;
+      while (buffer.size() < total) {
+        buffer += std::string(line_size, 'x') + '\n';
+      }
+      buffer.resize(total);
+      EXPECT_EQ(SplitWithScanner(buffer), SplitWithFind(buffer))
+          << "line " << line_size << ", total " << total;
+    }
+  }
+}
+
+TEST(LineScannerTest, match_block) {
+  std::string block(s21::kScanBlockSize, 'a');
+  block[0] = '/';
+  block[17] = '/';
+  block[63] = '/';
+  EXPECT_EQ(s21::MatchBlock(block.data(), '/'),
+            (1ull << 0) | (1ull << 17) | (1ull << 63));
+  EXPECT_EQ(s21::MatchTail(block.data(), 20, '/'), (1ull << 0) | (1ull << 17));
+}
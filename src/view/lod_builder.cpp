@@ -0,0 +1,56 @@
+#include "view/lod_builder.h"
+
+namespace s21 {
+
+LodBuilder::LodBuilder(QObject* parent) : QObject(parent) {}
+
+LodBuilder::~LodBuilder() {
+  Cancel();
+  for (auto& [generation, worker] : workers_) worker.thread.join();
+}
+
+void LodBuilder::Start(std::shared_ptr<const WireframeObject> model) {
+  Cancel();
+  if (!model) return;
+
+  auto cancel = std::make_shared<std::atomic<bool>>(false);
+  unsigned generation = ++generation_;
+  unsigned thread_count = std::max(1u, ResolveThreadCount(0) - 1);
+  std::thread thread([this, model, generation, thread_count, cancel] {
+    LodChain chain;
+    try {
+      chain = BuildLodChain(*model, thread_count, cancel.get());
+    } catch (const std::bad_alloc&) {
+      // The model stays at full detail
+      LogError("LodBuilder", memory_error);
+    }
+    auto result = std::make_shared<const LodChain>(std::move(chain));
+    // Joined by the destructor before Qt drops the event, like ModelLoader
+    QMetaObject::invokeMethod(
+        this,
+        [this, generation, model, result] {
+          Finish(generation, model, result);
+        },
+        Qt::QueuedConnection);
+  });
+  workers_[generation] = Worker{std::move(thread), std::move(cancel)};
+}
+
+void LodBuilder::Cancel() {
+  for (auto& [generation, worker] : workers_) worker.cancel->store(true);
+}
+
+void LodBuilder::Finish(unsigned generation,
+                        std::shared_ptr<const WireframeObject> model,
+                        std::shared_ptr<const LodChain> chain) {
+  auto worker = workers_.find(generation);
+  if (worker == workers_.end()) return;
+  // The worker posted this as its last action, joining is immediate
+  worker->second.thread.join();
+  bool is_cancelled = worker->second.cancel->load();
+  workers_.erase(worker);
+  if (generation == generation_ && !is_cancelled && !chain->empty()) {
+    emit Built(std::move(model), std::move(chain));
+  }
+}
+}  // namespace s21
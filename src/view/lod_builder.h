@@ -0,0 +1,61 @@
+#ifndef VIEW_LOD_BUILDER_H
+#define VIEW_LOD_BUILDER_H
+
+#include <QMetaObject>
+#include <QObject>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "model/mesh_lod.h"
+#include "model/parser.h"
+
+namespace s21 {
+
+typedef std::vector<MeshLod> LodChain;
+
+/**
+ * @class LodBuilder
+ * @brief Builds the level of detail chain of a loaded model on a worker
+ * thread
+ *
+ * Start() returns immediately and BuildLodChain() runs on a std::thread,
+ * leaving one hardware thread to the GUI. The chain is delivered on the GUI
+ * thread through Built together with the model it was made for. Starting
+ * again cancels a chain still in progress without waiting for it: the old
+ * worker stops within a block of records, and its chain is dropped by
+ * generation when it arrives.
+ */
+class LodBuilder : public QObject {
+  Q_OBJECT
+
+ public:
+  explicit LodBuilder(QObject* parent = nullptr);
+  ~LodBuilder() override;
+
+  void Start(std::shared_ptr<const WireframeObject> model);
+  void Cancel();
+
+  Q_SIGNAL void Built(std::shared_ptr<const WireframeObject> model,
+                      std::shared_ptr<const LodChain> chain);
+
+ private:
+  struct Worker {
+    std::thread thread;
+    // Shared with the thread, which checks it while clustering
+    std::shared_ptr<std::atomic<bool>> cancel;
+  };
+
+  void Finish(unsigned generation, std::shared_ptr<const WireframeObject> model,
+              std::shared_ptr<const LodChain> chain);
+
+  // By generation; a worker is joined once it posted its Finish()
+  std::map<unsigned, Worker> workers_;
+  // Tells the current chain from ones that were replaced
+  unsigned generation_ = 0;
+};
+}  // namespace s21
+
+#endif  // VIEW_LOD_BUILDER_H
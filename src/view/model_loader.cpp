@@ -0,0 +1,82 @@
+#include "view/model_loader.h"
+
+namespace s21 {
+
+ModelLoader::ModelLoader(QObject* parent) : QObject(parent) {
+  progress_timer_ = new QTimer(this);
+  progress_timer_->setInterval(kLoadProgressIntervalMs);
+  connect(progress_timer_, &QTimer::timeout, this, &ModelLoader::PollProgress);
+}
+
+ModelLoader::~ModelLoader() {
+  Cancel();
+  Wait();
+}
+
+void ModelLoader::Start(const std::string& file_path,
+                        const LoadOptions& options) {
+  Cancel();
+  Wait();
+
+  progress_ = std::make_shared<LoadProgress>();
+  stream_ = std::make_shared<MeshStream>();
+  is_loading_ = true;
+  unsigned generation = ++generation_;
+  progress_timer_->start();
+
+  LoadOptions worker_options = options;
+  worker_options.progress = progress_.get();
+  worker_options.stream = stream_.get();
+  worker_ = std::thread([this, file_path, worker_options, generation,
+                         progress = progress_, stream = stream_] {
+    std::shared_ptr<WireframeObject> model;
+    if (auto loaded = WireframeObject::Load(file_path, worker_options)) {
+      model = std::make_shared<WireframeObject>(std::move(*loaded));
+    }
+    // Hand the result over to the GUI thread; the object outlives this
+    // thread because the destructor joins it before Qt drops the event
+    QMetaObject::invokeMethod(
+        this, [this, generation, model] { Finish(generation, model); },
+        Qt::QueuedConnection);
+  });
+}
+
+void ModelLoader::Cancel() {
+  if (progress_) progress_->Cancel();
+}
+
+void ModelLoader::Wait() {
+  if (worker_.joinable()) worker_.join();
+}
+
+std::vector<MeshBatch> ModelLoader::TakeBatches() {
+  return stream_ ? stream_->TakeBatches() : std::vector<MeshBatch>();
+}
+
+void ModelLoader::PollProgress() {
+  if (!progress_) return;
+  emit ProgressChanged(progress_->GetBytesProcessed(),
+                       progress_->GetTotalBytes(),
+                       progress_->GetRecordsParsed());
+  if (stream_->HasBatches()) emit BatchesReady();
+}
+
+void ModelLoader::Finish(unsigned generation,
+                         std::shared_ptr<WireframeObject> model) {
+  // A load replaced by Start() was already joined there
+  if (generation != generation_) return;
+  // The worker posted this as its last action, joining is immediate
+  Wait();
+  progress_timer_->stop();
+  PollProgress();
+  is_loading_ = false;
+
+  if (model) {
+    emit Loaded(std::move(model));
+  } else if (progress_->IsCancelled()) {
+    emit Cancelled();
+  } else {
+    emit Failed();
+  }
+}
+}  // namespace s21
@@ -0,0 +1,70 @@
+#ifndef VIEW_MODEL_LOADER_H
+#define VIEW_MODEL_LOADER_H
+
+#include <QMetaObject>
+#include <QObject>
+#include <QTimer>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "model/load_progress.h"
+#include "model/mesh_stream.h"
+#include "model/parser.h"
+
+namespace s21 {
+
+// How often the GUI thread samples the progress counters
+const int kLoadProgressIntervalMs = 50;
+
+/**
+ * @class ModelLoader
+ * @brief Loads a WireframeObject on a worker thread
+ *
+ * Start() returns immediately; the file is parsed on a std::thread while the
+ * GUI keeps painting and handling input. Progress counters are sampled on the
+ * GUI thread and re-emitted as ProgressChanged, so a fast parser can't flood
+ * the event queue. At the same rate BatchesReady announces newly parsed
+ * geometry, which TakeBatches() hands out as a growing prefix of the mesh
+ * for progressive display. The outcome is delivered on the GUI thread as exactly one
+ * of Loaded, Failed or Cancelled; the mesh is moved, not copied, into the
+ * shared pointer handed to Loaded.
+ */
+class ModelLoader : public QObject {
+  Q_OBJECT
+
+ public:
+  explicit ModelLoader(QObject* parent = nullptr);
+  ~ModelLoader() override;
+
+  // Cancels and waits for a load that is still running before starting
+  void Start(const std::string& file_path, const LoadOptions& options);
+  void Cancel();
+  bool IsLoading() const { return is_loading_; }
+  // Geometry parsed since the previous call, in file order
+  std::vector<MeshBatch> TakeBatches();
+
+  Q_SIGNAL void ProgressChanged(quint64 bytes_processed, quint64 total_bytes,
+                                quint64 records_parsed);
+  Q_SIGNAL void BatchesReady();
+  Q_SIGNAL void Loaded(std::shared_ptr<WireframeObject> model);
+  Q_SIGNAL void Failed();
+  Q_SIGNAL void Cancelled();
+
+ private:
+  void PollProgress();
+  void Finish(unsigned generation, std::shared_ptr<WireframeObject> model);
+  void Wait();
+
+  std::thread worker_;
+  // Shared with the worker, which may still run while a new load starts
+  std::shared_ptr<LoadProgress> progress_;
+  std::shared_ptr<MeshStream> stream_;
+  QTimer* progress_timer_{nullptr};
+  bool is_loading_ = false;
+  // Tells the result of the current load from one that was cancelled
+  unsigned generation_ = 0;
+};
+}  // namespace s21
+
+#endif  // VIEW_MODEL_LOADER_H
@@ -9,7 +9,11 @@
 #include <GL/glu.h>
 #endif
 
+#include <QMatrix4x4>
 #include <QOpenGLFunctions>
+#include <QOpenGLShaderProgram>
+
+#include "view/shaders.h"
 
 namespace s21 {
 
@@ -19,6 +23,8 @@ const int kLongStripplePattern = 0x00FF;
 const int kMediumStipplePattern = 0x0F0F;
 // Частые штрихи: - - - - - - - -
 const int kShortStripplePattern = 0xAAAA;
+// Сплошная линия
+const int kSolidStipplePattern = 0xFFFF;
 
 static void PerspectiveProjection(int width, int height) {
   float aspect = static_cast<float>(width) / height;
@@ -46,11 +52,47 @@ static void CircleVertices() {
   glHint(GL_POINT_SMOOTH_HINT, GL_NICEST);
 }
 
+// Shader counterparts: the projection goes into the MVP matrix, the display
+// methods set uniforms of the bound program instead of GL state
+
+static void ShaderPerspectiveProjection(int width, int height,
+                                        QMatrix4x4& projection) {
+  float aspect = static_cast<float>(width) / height;
+  projection.perspective(45.0f, aspect, 0.1f, 100.0f);
+}
+
+static void ShaderOrthographicProjection(int width, int height,
+                                         QMatrix4x4& projection) {
+  float aspect = static_cast<float>(width) / height;
+  float orthoScale = 1.2f;
+  projection.ortho(-aspect * orthoScale, aspect * orthoScale, -orthoScale,
+                   orthoScale, -10.0f, 10.0f);
+}
+
+static void ShaderSolidEdges(QOpenGLShaderProgram& program) {
+  program.setUniformValue(kStippleUniform, kSolidStipplePattern);
+}
+
+static void ShaderDashedEdges(QOpenGLShaderProgram& program) {
+  program.setUniformValue(kStippleUniform, kMediumStipplePattern);
+}
+
+static void ShaderSquareVertices(QOpenGLShaderProgram& program) {
+  program.setUniformValue(kRoundPointsUniform, 0);
+}
+
+static void ShaderCircleVertices(QOpenGLShaderProgram& program) {
+  program.setUniformValue(kRoundPointsUniform, 1);
+}
+
 class OpenGLStrategy {
  public:
   typedef void (*ProjectionFunction)(int width, int height);
   typedef void (*EdgeDisplayFunction)();
   typedef void (*VertexDisplayFunction)();
+  typedef void (*ShaderProjectionFunction)(int width, int height,
+                                           QMatrix4x4& projection);
+  typedef void (*ShaderDisplayFunction)(QOpenGLShaderProgram& program);
 
   void SetProjectionFunction(ProjectionFunction func) {
     projection_func_ = func;
@@ -64,6 +106,14 @@ class OpenGLStrategy {
     vertex_display_func_ = func;
   }
 
+  void SetShaderFunctions(ShaderProjectionFunction projection,
+                          ShaderDisplayFunction edge_display,
+                          ShaderDisplayFunction vertex_display) {
+    shader_projection_func_ = projection;
+    shader_edge_display_func_ = edge_display;
+    shader_vertex_display_func_ = vertex_display;
+  }
+
   void ApplyProjection(int width, int height) {
     projection_func_(width, height);
   }
@@ -72,10 +122,26 @@ class OpenGLStrategy {
 
   void ApplyVertexDisplay() { vertex_display_func_(); }
 
+  void ApplyShaderProjection(int width, int height, QMatrix4x4& projection) {
+    shader_projection_func_(width, height, projection);
+  }
+
+  void ApplyShaderEdgeDisplay(QOpenGLShaderProgram& program) {
+    shader_edge_display_func_(program);
+  }
+
+  void ApplyShaderVertexDisplay(QOpenGLShaderProgram& program) {
+    shader_vertex_display_func_(program);
+  }
+
  private:
   ProjectionFunction projection_func_ = OrthographicProjection;
   EdgeDisplayFunction edge_display_func_ = SolidEdges;
   VertexDisplayFunction vertex_display_func_ = SquareVertices;
+  ShaderProjectionFunction shader_projection_func_ =
+      ShaderOrthographicProjection;
+  ShaderDisplayFunction shader_edge_display_func_ = ShaderSolidEdges;
+  ShaderDisplayFunction shader_vertex_display_func_ = ShaderSquareVertices;
 };  // class OpenGLStrategy
 }  // namespace s21
 
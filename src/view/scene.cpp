@@ -2,38 +2,453 @@
 
 namespace s21 {
 Scene::Scene(QWidget* parent)
-    : QOpenGLWidget(parent), vbo_(QOpenGLBuffer::VertexBuffer) {
+    : QOpenGLWidget(parent),
+      vbo_(QOpenGLBuffer::VertexBuffer),
+      ibo_(QOpenGLBuffer::IndexBuffer),
+      edge_ibo_(QOpenGLBuffer::IndexBuffer) {
   setFocusPolicy(Qt::StrongFocus);
+  // Keep the last frame when paintGL() has nothing new to draw
+  setUpdateBehavior(QOpenGLWidget::PartialUpdate);
   rotation_matrix_ = S21Matrix(4, 4);
   // Создаем единичную матрицу
   for (int i = 0; i < 4; ++i) {
     rotation_matrix_(i, i) = 1.0;
   }
   settings_ = SettingsFacade::GetInstance();
+
+  interaction_timer_ = new QTimer(this);
+  interaction_timer_->setSingleShot(true);
+  interaction_timer_->setInterval(kInteractionSettleMs);
+  // Redraw the whole cloud once zooming has stopped
+  connect(interaction_timer_, &QTimer::timeout, this,
+          [this] { RequestRedraw(); });
+  connect(this, &QOpenGLWidget::frameSwapped, this, &Scene::OnFrameSwapped);
 }
 
 Scene::~Scene() {
+  makeCurrent();
   vbo_.destroy();
+  ibo_.destroy();
+  edge_ibo_.destroy();
+  vao_.destroy();
+  program_.reset();
+  low_res_fbo_.reset();
+  for (LodBuffers& buffers : lod_buffers_) {
+    buffers.vbo.destroy();
+    buffers.edge_ibo.destroy();
+  }
+  doneCurrent();
   settings_->SaveSettingsToFile();
 }
 
-void Scene::SetModel(const std::shared_ptr<WireframeObject> model) {
-  model_ = model;
-  vbo_.create();
-  vbo_.bind();
-  vbo_.allocate(model_->GetVertices().data(),
-                model_->GetVertices().size() * sizeof(QVector3D));
-  vbo_.release();
+void Scene::SetModel(std::shared_ptr<const WireframeObject> model,
+                     bool continues_stream) {
+  // The finished mesh starts with the records streamed from the same load,
+  // which are already on the GPU: only the rest has to be uploaded. Welding
+  // renumbers the vertices, so a welded mesh is uploaded from scratch.
+  continues_stream = continues_stream && is_streaming_ && model &&
+                     model->KeepsStreamedPrefix() &&
+                     model->GetVertexCount() >= stream_vertices_.size() &&
+                     model->GetFaceCount() >= stream_faces_.size();
+  if (!continues_stream) {
+    uploaded_vertices_ = 0;
+    uploaded_faces_ = 0;
+  }
+  is_streaming_ = false;
+  stream_vertices_ = std::vector<Coordinate>();
+  stream_faces_ = std::vector<Face>();
+  uploaded_edges_ = 0;
+  // The next model may be cheap enough for full resolution
+  render_scale_ = 1.0f;
+  ReleaseLods();
+  model_ = std::move(model);
+  RequestRedraw();
+}
+
+void Scene::AppendBatches(std::vector<MeshBatch> batches) {
+  if (!is_streaming_) {
+    is_streaming_ = true;
+    // The preview outlines its triangles until the model arrives
+    model_.reset();
+    uploaded_vertices_ = 0;
+    uploaded_faces_ = 0;
+  }
+  for (MeshBatch& batch : batches) {
+    stream_vertices_.insert(stream_vertices_.end(), batch.vertices.begin(),
+                            batch.vertices.end());
+    stream_faces_.insert(stream_faces_.end(), batch.faces.begin(),
+                         batch.faces.end());
+  }
+  RequestRedraw();
+}
+
+void Scene::SetLods(std::shared_ptr<const WireframeObject> model,
+                    std::shared_ptr<const std::vector<MeshLod>> lods) {
+  if (!model || model != model_) return;
+  ReleaseLods();
+  lods_ = std::move(lods);
+  lod_buffers_.resize(lods_->size());
+  RequestRedraw();
 }
 
-void Scene::initializeGL() { glEnable(GL_DEPTH_TEST); }
+void Scene::ReleaseLods() {
+  // Buffers exist only once a frame drew them, so the context does too
+  bool has_buffers = std::any_of(
+      lod_buffers_.begin(), lod_buffers_.end(),
+      [](const LodBuffers& buffers) { return buffers.vbo.isCreated(); });
+  if (has_buffers) {
+    makeCurrent();
+    for (LodBuffers& buffers : lod_buffers_) {
+      buffers.vbo.destroy();
+      buffers.edge_ibo.destroy();
+    }
+    doneCurrent();
+  }
+  lod_buffers_.clear();
+  lods_.reset();
+}
+
+void Scene::RequestRedraw() {
+  ++scene_version_;
+  // Qt merges the requests into one paint per frame
+  update();
+}
+
+std::span<const Coordinate> Scene::GetSourceVertices() const {
+  if (model_) return model_->GetVertices();
+  return stream_vertices_;
+}
+
+std::span<const Face> Scene::GetSourceFaces() const {
+  if (model_) return model_->GetFaces();
+  return stream_faces_;
+}
+
+std::span<const Edge> Scene::GetSourceEdges() const {
+  if (model_) return model_->GetEdges();
+  return {};
+}
+
+template <typename T>
+void Scene::UploadTail(QOpenGLBuffer& buffer, std::size_t& capacity,
+                       std::size_t& uploaded, std::span<const T> records) {
+  // QOpenGLBuffer takes int sizes, whatever doesn't fit is left out
+  records = records.first(std::min<std::size_t>(
+      records.size(), std::numeric_limits<int>::max() / sizeof(T)));
+  if (!buffer.isCreated()) buffer.create();
+  buffer.bind();
+  // Grow geometrically so a stream of batches is uploaded in linear time,
+  // give memory back when a much smaller model replaces a big one
+  bool is_too_small = records.size() > capacity;
+  bool is_oversized = uploaded == 0 && capacity > kMinBufferRecords &&
+                      records.size() < capacity / 4;
+  if (is_too_small || is_oversized) {
+    std::size_t grown = is_too_small ? capacity * 2 : 0;
+    capacity = std::max({kMinBufferRecords, records.size(), grown});
+    buffer.allocate(static_cast<int>(capacity * sizeof(T)));
+    uploaded = 0;
+  }
+  if (records.size() > uploaded) {
+    buffer.write(static_cast<int>(uploaded * sizeof(T)),
+                 records.data() + uploaded,
+                 static_cast<int>((records.size() - uploaded) * sizeof(T)));
+  }
+  uploaded = records.size();
+  buffer.release();
+}
+
+void Scene::SyncBuffers() {
+  UploadTail(vbo_, vbo_capacity_, uploaded_vertices_, GetSourceVertices());
+  // Faces may point past a truncated vertex buffer, such a mesh is drawn
+  // by its vertices only
+  std::span<const Face> faces = GetSourceFaces();
+  std::span<const Edge> edges = GetSourceEdges();
+  if (IsPointsOnly()) {
+    faces = {};
+    edges = {};
+  }
+  // A model with its edge list never draws the triangles themselves, the
+  // preview's triangle buffer is given back once the edges replace it
+  if (!edges.empty()) {
+    UploadTail(edge_ibo_, edge_capacity_, uploaded_edges_, edges);
+    if (ibo_.isCreated()) {
+      ibo_.destroy();
+      ibo_capacity_ = 0;
+      uploaded_faces_ = 0;
+    }
+  } else {
+    UploadTail(ibo_, ibo_capacity_, uploaded_faces_, faces);
+  }
+}
+
+bool Scene::IsPointsOnly() const {
+  // Point clouds and meshes with 64-bit indices have no 32-bit faces
+  return GetSourceFaces().empty() ||
+         uploaded_vertices_ < GetSourceVertices().size();
+}
+
+bool Scene::IsInteracting() const {
+  return is_dragging_ || is_rotating_ || interaction_timer_->isActive();
+}
+
+void Scene::initializeGL() {
+  glEnable(GL_DEPTH_TEST);
+  if (!InitializeShaders()) {
+    program_.reset();
+    LogError("Scene", "Shaders are unavailable, using the fixed pipeline");
+  }
+}
+
+bool Scene::InitializeShaders() {
+  program_ = std::make_unique<QOpenGLShaderProgram>();
+  program_->bindAttributeLocation(kPositionName, kPositionAttribute);
+  if (!program_->addShaderFromSourceCode(QOpenGLShader::Vertex,
+                                         kWireframeVertexShader) ||
+      !program_->addShaderFromSourceCode(QOpenGLShader::Fragment,
+                                         kWireframeFragmentShader) ||
+      !program_->link()) {
+    LogError("Scene", program_->log().toStdString());
+    return false;
+  }
+  needs_point_sprite_ =
+      context()->format().profile() != QSurfaceFormat::CoreProfile;
+  return vao_.create();
+}
+
+void Scene::resizeGL(int /*width*/, int /*height*/) { ++scene_version_; }
 
 void Scene::paintGL() {
+  ApplyPendingInput();
+  // The framebuffer still holds this version of the scene
+  GLuint framebuffer = defaultFramebufferObject();
+  if (scene_version_ == painted_version_ &&
+      framebuffer == painted_framebuffer_) {
+    ++frame_stats_.skipped;
+    return;
+  }
+  frame_timer_.start();
+
+  qreal pixel_ratio = devicePixelRatioF();
+  QSize full_size(qRound(width() * pixel_ratio),
+                  qRound(height() * pixel_ratio));
+  is_interactive_frame_ = IsInteracting();
+  frame_scale_ = 1.0f;
+  viewport_size_ = full_size;
+  if (is_interactive_frame_ && render_scale_ < 1.0f &&
+      BindLowResFramebuffer(full_size)) {
+    frame_scale_ = render_scale_;
+    viewport_size_ =
+        QSize(std::max(1, qRound(full_size.width() * render_scale_)),
+              std::max(1, qRound(full_size.height() * render_scale_)));
+    glViewport(0, 0, viewport_size_.width(), viewport_size_.height());
+  }
+
   auto bg = settings_->background_color_.GetOption();
   glClearColor(bg[0], bg[1], bg[2], bg[3]);
 
   glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
+  // Отрисовка модели
+  if (model_ || is_streaming_) {
+    SyncBuffers();
+    SelectGeometry();
+    if (program_ && settings_->renderer_.GetOption() == kRendererShader) {
+      PaintShaded();
+    } else {
+      PaintFixedFunction();
+    }
+  }
+
+  if (frame_scale_ < 1.0f) {
+    // Stretch the reduced frame over the widget's own framebuffer
+    low_res_fbo_->release();
+    QOpenGLFramebufferObject::blitFramebuffer(
+        nullptr, QRect(QPoint(), full_size), low_res_fbo_.get(),
+        QRect(QPoint(), viewport_size_), GL_COLOR_BUFFER_BIT, GL_LINEAR);
+    glViewport(0, 0, full_size.width(), full_size.height());
+  }
+
+  painted_version_ = scene_version_;
+  painted_framebuffer_ = framebuffer;
+  ++frame_stats_.repaints;
+}
+
+bool Scene::BindLowResFramebuffer(const QSize& full_size) {
+  // Reduced frames are drawn into its lower left corner: the scale changes
+  // from frame to frame, the allocation only when the widget is resized
+  if (!low_res_fbo_ || low_res_fbo_->size() != full_size) {
+    low_res_fbo_ = std::make_unique<QOpenGLFramebufferObject>(
+        full_size, QOpenGLFramebufferObject::CombinedDepthStencil);
+  }
+  return low_res_fbo_->isValid() && low_res_fbo_->bind();
+}
+
+void Scene::OnFrameSwapped() {
+  // Skipped frames are swapped too, with nothing drawn to time
+  if (!frame_timer_.isValid()) return;
+  frame_stats_.last_frame_ms = frame_timer_.nsecsElapsed() / 1e6;
+  frame_stats_.total_frame_ms += frame_stats_.last_frame_ms;
+  frame_timer_.invalidate();
+  if (is_interactive_frame_) AdaptRenderScale(frame_stats_.last_frame_ms);
+}
+
+void Scene::AdaptRenderScale(double frame_ms) {
+  if (frame_ms <= 0.0) return;
+  // Frame time is taken to follow the pixel count, the square of the scale;
+  // halfway steps keep it from swinging between two sizes
+  float wanted = frame_scale_ * static_cast<float>(
+                                    std::sqrt(kFrameBudgetMs / frame_ms));
+  render_scale_ = std::clamp(0.5f * (render_scale_ + wanted),
+                             kMinRenderScale, 1.0f);
+}
+
+QMatrix4x4 Scene::GetModelView() const {
+  // Same transforms as the fixed path: camera, scale, drag, rotation
+  QMatrix4x4 model_view;
+  model_view.translate(0.0f, 0.0f, -3.0f);
+  model_view.scale(scale_factor_);
+  model_view.translate(model_position_.x(), model_position_.y(), 0.0f);
+  // glMultMatrixd reads rotation_matrix_ column by column
+  float rotation[16];
+  std::copy_n(rotation_matrix_.get_matrix(), 16, rotation);
+  return model_view * QMatrix4x4(rotation).transposed();
+}
+
+std::size_t Scene::GetPointStride() const {
+  // Thin out big clouds while moving: every stride-th point, read straight
+  // from the same buffer through the vertex stride
+  if (IsInteracting() && frame_vertices_ > kInteractivePointBudget) {
+    return (frame_vertices_ + kInteractivePointBudget - 1) /
+           kInteractivePointBudget;
+  }
+  return 1;
+}
+
+int Scene::PickLod() {
+  if (!lods_ || !model_ || uploaded_edges_ == 0 || !IsInteracting()) {
+    return -1;
+  }
+  const Bounds& bounds = model_->GetBounds();
+  float diagonal = std::hypot(bounds.max.x - bounds.min.x,
+                              bounds.max.y - bounds.min.y,
+                              bounds.max.z - bounds.min.z);
+  // Pixels per unit at the model's centre, three units from the camera: the
+  // clip w there is 1 for the orthographic projection and 3 for perspective
+  QMatrix4x4 projection;
+  settings_->strategy_->ApplyShaderProjection(width(), height(), projection);
+  float clip_w = projection(3, 3) - 3.0f * projection(3, 2);
+  float pixels_per_unit =
+      projection(1, 1) * viewport_size_.height() / (2.0f * clip_w);
+  float projected = diagonal * scale_factor_ * pixels_per_unit;
+  // Levels go from fine to coarse
+  int level = -1;
+  for (std::size_t i = 0; i < lods_->size(); ++i) {
+    const MeshLod& lod = (*lods_)[i];
+    if (lod.edges.empty() || projected / lod.grid_cells > kLodCellPixels) {
+      break;
+    }
+    level = static_cast<int>(i);
+  }
+  return level;
+}
+
+void Scene::SelectGeometry() {
+  frame_vbo_ = &vbo_;
+  frame_edge_ibo_ = &edge_ibo_;
+  frame_vertices_ = uploaded_vertices_;
+  frame_edges_ = uploaded_edges_;
+  int level = PickLod();
+  if (level < 0) return;
+
+  const MeshLod& lod = (*lods_)[level];
+  LodBuffers& buffers = lod_buffers_[level];
+  if (!buffers.vbo.isCreated()) {
+    // Levels are a fraction of the model, which fit int sizes already
+    buffers.vbo.create();
+    buffers.vbo.bind();
+    buffers.vbo.allocate(
+        lod.vertices.data(),
+        static_cast<int>(lod.vertices.size() * sizeof(Coordinate)));
+    buffers.vbo.release();
+    buffers.edge_ibo.create();
+    buffers.edge_ibo.bind();
+    buffers.edge_ibo.allocate(
+        lod.edges.data(), static_cast<int>(lod.edges.size() * sizeof(Edge)));
+    buffers.edge_ibo.release();
+  }
+  frame_vbo_ = &buffers.vbo;
+  frame_edge_ibo_ = &buffers.edge_ibo;
+  frame_vertices_ = lod.vertices.size();
+  frame_edges_ = lod.edges.size();
+}
+
+void Scene::PaintShaded() {
+  if (fixed_function_state_) {
+    SolidEdges();
+    SquareVertices();
+    fixed_function_state_ = false;
+  }
+  QMatrix4x4 mvp;
+  settings_->strategy_->ApplyShaderProjection(width(), height(), mvp);
+  mvp *= GetModelView();
+
+  program_->bind();
+  program_->setUniformValue(kMvpUniform, mvp);
+  program_->setUniformValue(
+      kViewportUniform,
+      QVector2D(viewport_size_.width(), viewport_size_.height()));
+  vao_.bind();
+  frame_vbo_->bind();
+  program_->enableAttributeArray(kPositionAttribute);
+  program_->setAttributeBuffer(kPositionAttribute, GL_FLOAT, 0, 3);
+
+  glLineWidth(
+      std::max(1.0f, settings_->edge_width_.GetSize() * frame_scale_));
+  settings_->strategy_->ApplyShaderEdgeDisplay(*program_);
+  auto edge_color = settings_->edge_color_.GetOption();
+  program_->setUniformValue(
+      kColorUniform, QVector3D(edge_color[0], edge_color[1], edge_color[2]));
+  program_->setUniformValue(kIsPointUniform, 0);
+  if (frame_edges_ != 0) {
+    frame_edge_ibo_->bind();
+    glDrawElements(GL_LINES, static_cast<GLsizei>(frame_edges_ * 2),
+                   GL_UNSIGNED_INT, nullptr);
+  } else if (uploaded_faces_ != 0) {
+    ibo_.bind();
+    glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(uploaded_faces_ * 3),
+                   GL_UNSIGNED_INT, nullptr);
+    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+  }
+
+  if (settings_->vertex_display_method_.GetName() != "none" ||
+      IsPointsOnly()) {
+    std::size_t stride = GetPointStride();
+    program_->setAttributeBuffer(
+        kPositionAttribute, GL_FLOAT, 0, 3,
+        static_cast<int>(stride * sizeof(Coordinate)));
+    glPointSize(
+        std::max(1.0f, settings_->vertex_size_.GetSize() * frame_scale_));
+    settings_->strategy_->ApplyShaderVertexDisplay(*program_);
+    auto vertex_color = settings_->vertex_color_.GetOption();
+    program_->setUniformValue(
+        kColorUniform,
+        QVector3D(vertex_color[0], vertex_color[1], vertex_color[2]));
+    program_->setUniformValue(kIsPointUniform, 1);
+    // Point sprites would also switch off GL_POINT_SMOOTH of the fixed path
+    if (needs_point_sprite_) glEnable(GL_POINT_SPRITE);
+    std::size_t point_count = (frame_vertices_ + stride - 1) / stride;
+    glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(point_count));
+    if (needs_point_sprite_) glDisable(GL_POINT_SPRITE);
+  }
+  // The element buffer binding belongs to the VAO, leave it there
+  vao_.release();
+  frame_vbo_->release();
+  program_->release();
+}
+
+void Scene::PaintFixedFunction() {
+  fixed_function_state_ = true;
   //--------------------------------------------------------------------
   // Настройка проекции
   glMatrixMode(GL_PROJECTION);
@@ -52,30 +467,38 @@ void Scene::paintGL() {
   glTranslatef(model_position_.x(), model_position_.y(), 0.0f);
   glMultMatrixd(rotation_matrix_.get_matrix());
 
-  // Отрисовка модели
-  if (model_) {
-    glLineWidth(settings_->edge_width_.GetSize());
-
-    settings_->strategy_->ApplyEdgeDisplay();
-
-    auto edge_color = settings_->edge_color_.GetOption();
-    glColor3f(edge_color[0], edge_color[1], edge_color[2]);
-
-    glBegin(GL_LINES);
-    for (const auto face : model_->GetFaces()) {
-      for (int i = 0; i < 3; ++i) {
-        int j = (i + 1) % 3;
-        glVertex3f(face.position[i]->x, face.position[i]->y,
-                   face.position[i]->z);
-        glVertex3f(face.position[j]->x, face.position[j]->y,
-                   face.position[j]->z);
-      }
-    }
-    glEnd();
+  glLineWidth(
+      std::max(1.0f, settings_->edge_width_.GetSize() * frame_scale_));
 
-    if (settings_->vertex_display_method_.GetName() != "none") {
-      DrawAllVertices();
-    }
+  settings_->strategy_->ApplyEdgeDisplay();
+
+  auto edge_color = settings_->edge_color_.GetOption();
+  glColor3f(edge_color[0], edge_color[1], edge_color[2]);
+
+  frame_vbo_->bind();
+  glEnableClientState(GL_VERTEX_ARRAY);
+  glVertexPointer(3, GL_FLOAT, 0, nullptr);
+  if (frame_edges_ != 0) {
+    // Each edge once, without the diagonals of triangulated polygons
+    frame_edge_ibo_->bind();
+    glDrawElements(GL_LINES, static_cast<GLsizei>(frame_edges_ * 2),
+                   GL_UNSIGNED_INT, nullptr);
+    frame_edge_ibo_->release();
+  } else {
+    // Triangles are outlined, every face edge becomes a line
+    ibo_.bind();
+    glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(uploaded_faces_ * 3),
+                   GL_UNSIGNED_INT, nullptr);
+    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+    ibo_.release();
+  }
+  glDisableClientState(GL_VERTEX_ARRAY);
+  frame_vbo_->release();
+
+  if (settings_->vertex_display_method_.GetName() != "none" ||
+      IsPointsOnly()) {
+    DrawAllVertices();
   }
 }
 
@@ -83,14 +506,20 @@ void Scene::DrawAllVertices() {
   auto vertex_color = settings_->vertex_color_.GetOption();
   glColor3f(vertex_color[0], vertex_color[1], vertex_color[2]);
 
-  glPointSize(settings_->vertex_size_.GetSize());
+  glPointSize(
+      std::max(1.0f, settings_->vertex_size_.GetSize() * frame_scale_));
 
   settings_->strategy_->ApplyVertexDisplay();
 
+  std::size_t stride = GetPointStride();
+  frame_vbo_->bind();
   glEnableClientState(GL_VERTEX_ARRAY);
-  glVertexPointer(3, GL_FLOAT, 0, model_->GetVertices().data());
-  glDrawArrays(GL_POINTS, 0, model_->GetVertices().size());
+  glVertexPointer(3, GL_FLOAT,
+                  static_cast<GLsizei>(stride * sizeof(Coordinate)), nullptr);
+  std::size_t point_count = (frame_vertices_ + stride - 1) / stride;
+  glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(point_count));
   glDisableClientState(GL_VERTEX_ARRAY);
+  frame_vbo_->release();
 }
 
 }  // namespace s21
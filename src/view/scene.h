@@ -7,12 +7,26 @@
 #include <GL/gl.h>
 #endif
 
+#include <QElapsedTimer>
+#include <QMatrix4x4>
 #include <QOpenGLBuffer>
+#include <QOpenGLFramebufferObject>
+#include <QOpenGLShaderProgram>
+#include <QOpenGLVertexArrayObject>
 #include <QOpenGLWidget>
+#include <QTimer>
 #include <QVector3D>
 #include <QWheelEvent>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
 #include <memory>
+#include <span>
+#include <vector>
 
+#include "model/mesh_lod.h"
+#include "model/mesh_stream.h"
 #include "model/parser.h"
 #include "model/s21_matrix_oop.h"
 #include "view/settings_facade.h"
@@ -23,6 +37,30 @@ const float kBaseSensitivity = 0.005f;
 const float kMinSensitivity = 0.00001f;
 const float kMaxSensitivity = 0.1f;
 
+// Smallest GPU buffer allocation in records, buffers grow by doubling
+const std::size_t kMinBufferRecords = 1 << 16;
+// Points drawn per frame while the model is moved; bigger clouds are thinned
+// out so software rendering keeps up with the mouse
+const std::size_t kInteractivePointBudget = 2000000;
+// Time after the last wheel step before the full cloud is drawn again
+const int kInteractionSettleMs = 200;
+// Frame time aimed at while the model is moved, and the lowest fraction of
+// the widget's resolution the scene may be drawn at to reach it
+const double kFrameBudgetMs = 1000.0 / 60.0;
+const float kMinRenderScale = 0.25f;
+// A coarser level of detail is drawn while its clustering cells stay this
+// small on screen, in pixels of the frame being drawn
+const float kLodCellPixels = 2.0f;
+
+// Counters of paintGL calls, read by the UI to check redraws are skipped
+struct FrameStats {
+  std::uint64_t repaints = 0;  // Frames actually drawn
+  std::uint64_t skipped = 0;   // Paint requests with nothing new to draw
+  // From the start of paintGL() to the frame being on screen
+  double last_frame_ms = 0.0;
+  double total_frame_ms = 0.0;
+};
+
 /**
  * @class Scene
  * @brief OpenGL-based 3D scene viewer widget
@@ -36,7 +74,8 @@ const float kMaxSensitivity = 0.1f;
  * The class manages the OpenGL rendering context and maintains the model's
  * transformation state including rotation, scale, and position. It integrates
  * with the application's settings system to apply user-defined rendering
- * preferences.
+ * preferences. Geometry stays in GPU buffers between frames, and a frame is
+ * only drawn when the scene changed.
  */
 class Scene : public QOpenGLWidget {
   Q_OBJECT
@@ -44,7 +83,20 @@ class Scene : public QOpenGLWidget {
  public:
   Scene(QWidget* parent = nullptr);
   ~Scene() override;
-  void SetModel(const std::shared_ptr<WireframeObject> model);
+  // continues_stream: model is the result of the load that streamed the
+  // preview, and may keep the preview's records already on the GPU
+  void SetModel(std::shared_ptr<const WireframeObject> model,
+                bool continues_stream = false);
+  // Appends geometry of the model being loaded and shows it instead of the
+  // current one; SetModel() ends the preview
+  void AppendBatches(std::vector<MeshBatch> batches);
+  bool IsStreaming() const { return is_streaming_; }
+  // Levels of detail of model, ignored unless it is the model shown
+  void SetLods(std::shared_ptr<const WireframeObject> model,
+               std::shared_ptr<const std::vector<MeshLod>> lods);
+  // Marks the scene changed and schedules a frame
+  void RequestRedraw();
+  const FrameStats& GetFrameStats() const { return frame_stats_; }
 
   void wheelEvent(QWheelEvent* event) override;
   void mousePressEvent(QMouseEvent* event) override;
@@ -56,10 +108,88 @@ class Scene : public QOpenGLWidget {
  protected:
   void initializeGL() override;
   void paintGL() override;
+  void resizeGL(int width, int height) override;
+  Q_SLOT void OnFrameSwapped();
+  bool BindLowResFramebuffer(const QSize& full_size);
+  void AdaptRenderScale(double frame_ms);
+  void ApplyPendingInput();
+  bool InitializeShaders();
+  void PaintShaded();
+  void PaintFixedFunction();
   void DrawAllVertices();
+  QMatrix4x4 GetModelView() const;
+  std::size_t GetPointStride() const;
+  int PickLod();
+  void SelectGeometry();
+  void ReleaseLods();
+  void SyncBuffers();
+  // Point clouds and meshes with 64-bit indices are drawn as points
+  bool IsPointsOnly() const;
+  bool IsInteracting() const;
+  template <typename T>
+  void UploadTail(QOpenGLBuffer& buffer, std::size_t& capacity,
+                  std::size_t& uploaded, std::span<const T> records);
+  std::span<const Coordinate> GetSourceVertices() const;
+  std::span<const Face> GetSourceFaces() const;
+  std::span<const Edge> GetSourceEdges() const;
 
+  // A frame is one draw call for the wireframe and one for the points. The
+  // loaded model is drawn from its edge list, the streamed preview outlines
+  // its triangles.
   QOpenGLBuffer vbo_;
-  std::shared_ptr<WireframeObject> model_{nullptr};
+  QOpenGLBuffer ibo_;
+  QOpenGLBuffer edge_ibo_;
+  // Cuts dashes and round points in the fragment shader; null when the
+  // context can't build it, which falls back to the fixed-function path
+  std::unique_ptr<QOpenGLShaderProgram> program_;
+  QOpenGLVertexArrayObject vao_;
+  // gl_PointCoord needs GL_POINT_SPRITE outside a core profile context
+  bool needs_point_sprite_ = false;
+  // Line stipple or point smoothing may still be on from the fixed path
+  bool fixed_function_state_ = false;
+  // Version of the scene state and the one the framebuffer holds: paintGL()
+  // returns at once when PartialUpdate kept the current version on screen
+  std::uint64_t scene_version_ = 1;
+  std::uint64_t painted_version_ = 0;
+  GLuint painted_framebuffer_ = 0;
+  FrameStats frame_stats_;
+  // Runs from a drawn frame's paintGL() until it is swapped
+  QElapsedTimer frame_timer_;
+  // Interaction frames missing kFrameBudgetMs are drawn smaller, into a
+  // corner of low_res_fbo_, and stretched over the widget. The scale moves
+  // with render_scale_; a frame uses frame_scale_, 1 when it isn't reduced
+  std::unique_ptr<QOpenGLFramebufferObject> low_res_fbo_;
+  float render_scale_ = 1.0f;
+  float frame_scale_ = 1.0f;
+  bool is_interactive_frame_ = false;
+  QSize viewport_size_;
+  std::shared_ptr<const WireframeObject> model_{nullptr};
+  // Preview of the model being loaded, drawn while model_ is null
+  bool is_streaming_ = false;
+  std::vector<Coordinate> stream_vertices_;
+  std::vector<Face> stream_faces_;
+  // Records currently on the GPU and room allocated for them; SetModel()
+  // keeps a streamed prefix the finished model still starts with
+  std::size_t uploaded_vertices_ = 0;
+  std::size_t uploaded_faces_ = 0;
+  std::size_t vbo_capacity_ = 0;
+  std::size_t ibo_capacity_ = 0;
+  // Edges of model_ on the GPU
+  std::size_t uploaded_edges_ = 0;
+  std::size_t edge_capacity_ = 0;
+  // Levels of detail of model_ and their buffers, filled when first drawn.
+  // PickLod() draws one while the model is moved and zoomed out.
+  struct LodBuffers {
+    QOpenGLBuffer vbo{QOpenGLBuffer::VertexBuffer};
+    QOpenGLBuffer edge_ibo{QOpenGLBuffer::IndexBuffer};
+  };
+  std::shared_ptr<const std::vector<MeshLod>> lods_;
+  std::vector<LodBuffers> lod_buffers_;
+  // What the current frame draws: the buffers above or a level's
+  QOpenGLBuffer* frame_vbo_{nullptr};
+  QOpenGLBuffer* frame_edge_ibo_{nullptr};
+  std::size_t frame_vertices_ = 0;
+  std::size_t frame_edges_ = 0;
 
  private:
   SettingsFacade* settings_{nullptr};
@@ -71,6 +201,13 @@ class Scene : public QOpenGLWidget {
 
   bool is_rotating_ = false;
   QPoint last_rotate_pos_;
+  // Input received since the last frame, in pixels and wheel steps, applied
+  // once per frame by ApplyPendingInput()
+  QVector2D pending_drag_;
+  QVector2D pending_rotation_;
+  int pending_zoom_steps_ = 0;
+  // Runs for a moment after each wheel step
+  QTimer* interaction_timer_{nullptr};
   S21Matrix rotation_matrix_;  // Матрица поворота 4x4
   QVector3D rotation_angles_;  // Углы поворота по осям X,Y,Z
 };
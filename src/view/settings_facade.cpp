@@ -65,20 +65,30 @@ void SettingsFacade::ResetSettings() {
 }
 
 void SettingsFacade::UpdateStrategy() {
+  OpenGLStrategy::ShaderProjectionFunction shader_projection;
+  OpenGLStrategy::ShaderDisplayFunction shader_edges, shader_vertices;
   if (projection_type_.GetName() == "ortographic") {
     strategy_->SetProjectionFunction(OrthographicProjection);
+    shader_projection = ShaderOrthographicProjection;
   } else {
     strategy_->SetProjectionFunction(PerspectiveProjection);
+    shader_projection = ShaderPerspectiveProjection;
   }
   if (edge_display_method_.GetName() == "solid") {
     strategy_->SetEdgeDisplayFunction(SolidEdges);
+    shader_edges = ShaderSolidEdges;
   } else {
     strategy_->SetEdgeDisplayFunction(DashedEdges);
+    shader_edges = ShaderDashedEdges;
   }
   if (vertex_display_method_.GetName() == "circle") {
     strategy_->SetVertexDisplayFunction(CircleVertices);
+    shader_vertices = ShaderCircleVertices;
   } else {
     strategy_->SetVertexDisplayFunction(SquareVertices);
+    shader_vertices = ShaderSquareVertices;
   }
+  strategy_->SetShaderFunctions(shader_projection, shader_edges,
+                                shader_vertices);
 }
 }  // namespace s21
\ No newline at end of file
@@ -38,6 +38,12 @@ const int kMinTargetHeight = 90;
 const int kMaxTargetHeight = 720;
 const int kTargetHeight = 480;
 
+// Weld tolerances are fractions of the model's bounding box diagonal
+const float kWeldOff = -1.0f;
+const float kWeldExact = 0.0f;
+const float kWeldFine = 1e-6f;
+const float kWeldCoarse = 1e-4f;
+
 typedef enum {
   kOrtographic,  // Параллельная
   kPerspective   // Центральная
@@ -54,6 +60,11 @@ typedef enum {
   kEdgeDisplayDashed,
 } EdgeDisplayMethodT;
 
+typedef enum {
+  kRendererShader = 0,  // QOpenGLShaderProgram with a VAO
+  kRendererFixedFunction,
+} RendererTypeT;
+
 const std::array<float, 4> kDarkBlueBackgroundColor = {0.1f, 0.2f, 0.4f, 1.0f};
 const std::array<float, 4> kLightBlueBackgroundColor = {0.5f, 0.7f, 0.9f, 1.0f};
 const std::array<float, 4> kWhiteBackgroundColor = {1.0f, 1.0f, 1.0f, 1.0f};
@@ -92,6 +103,14 @@ const QString kSquareString = "square";
 const QString kSolidString = "solid";
 const QString kDashedString = "dashed";
 
+const QString kShaderString = "shader";
+const QString kFixedFunctionString = "fixed_function";
+
+const QString kWeldOffString = "off";
+const QString kWeldExactString = "exact";
+const QString kWeldFineString = "fine";
+const QString kWeldCoarseString = "coarse";
+
 const std::map<QString, const std::array<float, 4>> kBackgroundColors = {
     {kDarkBlueString, kDarkBlueBackgroundColor},
     {kLightBlueString, kLightBlueBackgroundColor},
@@ -115,6 +134,14 @@ const std::map<QString, const std::array<float, 3>> kEdgeColors = {
     {kBlackString, kBlackColor},     {kWhiteString, kWhiteColor}};
 const std::map<QString, EdgeDisplayMethodT> kEdgeDisplayMethods = {
     {kSolidString, kEdgeDisplaySolid}, {kDashedString, kEdgeDisplayDashed}};
+const std::map<QString, RendererTypeT> kRendererTypes = {
+    {kShaderString, kRendererShader},
+    {kFixedFunctionString, kRendererFixedFunction}};
+const std::map<QString, const float> kWeldTolerances = {
+    {kWeldOffString, kWeldOff},
+    {kWeldExactString, kWeldExact},
+    {kWeldFineString, kWeldFine},
+    {kWeldCoarseString, kWeldCoarse}};
 
 class IBasicSettings {
  public:
@@ -224,6 +251,26 @@ class EdgeDisplaySettings
   void SetDefaultValues() { SetOptionByName(kSolidString); }
 };  // class EdgeDisplaySettings
 
+class RendererSettings
+    : public BasicSettings<RendererTypeT, std::map<QString, RendererTypeT>> {
+ public:
+  RendererSettings() {
+    option_map_ = &kRendererTypes;
+    SetDefaultValues();
+  }
+  void SetDefaultValues() { SetOptionByName(kShaderString); }
+};  // class RendererSettings
+
+class WeldSettings
+    : public BasicSettings<float, std::map<QString, const float>> {
+ public:
+  WeldSettings() {
+    option_map_ = &kWeldTolerances;
+    SetDefaultValues();
+  }
+  void SetDefaultValues() { SetOptionByName(kWeldOffString); }
+};  // class WeldSettings
+
 class FloatSize {
  public:
   explicit FloatSize(float default_size) {
@@ -262,8 +309,10 @@ class IntSize {
  * managing all display-related settings for the 3D viewer application. It
  * handles:
  * - Background color configuration
+ * - Renderer: shader program or the fixed-function pipeline
  * - Vertex display properties (color, size, display method)
  * - Edge display properties (color, width, display method)
+ * - Vertex welding applied to models as they load
  *
  * The class provides methods for loading/saving settings from/to a file and
  * offers a comprehensive interface for getting and setting various display
@@ -288,6 +337,7 @@ class SettingsFacade {
 
   BackgroundSettings background_color_;
   ProjectionSettings projection_type_;
+  RendererSettings renderer_;
 
   VertexColorSettings vertex_color_;
   VertexDisplaySettings vertex_display_method_;
@@ -297,6 +347,8 @@ class SettingsFacade {
   EdgeDisplaySettings edge_display_method_;
   FloatSize edge_width_ = FloatSize(kDefaultEdgeSize);
 
+  WeldSettings weld_tolerance_;
+
   IntSize duration_sec_ = IntSize(kDurationSec);
   IntSize fps_ = IntSize(kFps);
   IntSize target_width_ = IntSize(kTargetWidth);
@@ -315,10 +367,12 @@ class SettingsFacade {
   const std::map<std::string, IBasicSettings*> settings_name_map_ = {
       {"background_color_", &background_color_},
       {"projection_type_", &projection_type_},
+      {"renderer_", &renderer_},
       {"vertex_color_", &vertex_color_},
       {"vertex_display_method_", &vertex_display_method_},
       {"edge_color_", &edge_color_},
-      {"edge_display_method_", &edge_display_method_}};
+      {"edge_display_method_", &edge_display_method_},
+      {"weld_tolerance_", &weld_tolerance_}};
 
   const std::map<std::string, FloatSize*> settings_float_map_ = {
       {"vertex_size_", &vertex_size_}, {"edge_width_", &edge_width_}};
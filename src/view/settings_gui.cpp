@@ -10,6 +10,7 @@ void SettingsWindow::InitializeUI() {
   this->SetBackgroundSettings();
   this->SetVerticesSettings();
   this->SetEdgesSettings();
+  this->SetModelSettings();
   this->SetAnimationSettings();
   this->SetResetButton();
 
@@ -39,10 +40,16 @@ void SettingsWindow::SetBackgroundSettings() {
   projection_combo_ = new QComboBox;
   settings_->projection_type_.SetQComboBox(projection_combo_);
 
+  // The fixed-function pipeline stays for comparison
+  renderer_combo_ = new QComboBox;
+  settings_->renderer_.SetQComboBox(renderer_combo_);
+
   bg_layout->addWidget(new QLabel(tr("Color:")), 0, 0);
   bg_layout->addWidget(bg_color_combo_, 0, 1);
   bg_layout->addWidget(new QLabel(tr("Projection:")), 1, 0);
   bg_layout->addWidget(projection_combo_, 1, 1);
+  bg_layout->addWidget(new QLabel(tr("Renderer:")), 2, 0);
+  bg_layout->addWidget(renderer_combo_, 2, 1);
 
   bg_group->setLayout(bg_layout);
   bg_group->setStyleSheet(commonStyle);
@@ -103,6 +110,23 @@ void SettingsWindow::SetEdgesSettings() {
   main_layout_->addWidget(edge_group);
 }
 
+void SettingsWindow::SetModelSettings() {
+  auto model_group = new QGroupBox(tr("Model Settings"));
+  auto model_layout = new QGridLayout;
+
+  // Takes effect on the next model opened
+  weld_combo_ = new QComboBox;
+  weld_combo_->setFixedWidth(kComboWidth);
+  settings_->weld_tolerance_.SetQComboBox(weld_combo_);
+
+  model_layout->addWidget(new QLabel(tr("Weld vertices:")), 0, 0);
+  model_layout->addWidget(weld_combo_, 0, 1);
+
+  model_group->setLayout(model_layout);
+  model_group->setStyleSheet(commonStyle);
+  main_layout_->addWidget(model_group);
+}
+
 void SettingsWindow::SetAnimationSettings() {
   auto anim_group = new QGroupBox(tr("Animation Settings"));
   auto anim_layout = new QGridLayout;
@@ -156,10 +180,12 @@ void SettingsWindow::SetResetButton() {
 void SettingsWindow::InititializeMaps() {
   kComboBoxes = {{bg_color_combo_, &settings_->background_color_},
                  {projection_combo_, &settings_->projection_type_},
+                 {renderer_combo_, &settings_->renderer_},
                  {vertex_color_combo_, &settings_->vertex_color_},
                  {vertex_type_combo_, &settings_->vertex_display_method_},
                  {edge_color_combo_, &settings_->edge_color_},
-                 {edge_type_combo_, &settings_->edge_display_method_}};
+                 {edge_type_combo_, &settings_->edge_display_method_},
+                 {weld_combo_, &settings_->weld_tolerance_}};
   kSliders = {{vertex_size_slider_, &settings_->vertex_size_},
               {edge_thickness_slider_, &settings_->edge_width_}};
   kSpinBoxes = {{duration_spin_, &settings_->duration_sec_},
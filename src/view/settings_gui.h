@@ -176,6 +176,7 @@ class SettingsWindow : public QWidget {
   void SetBackgroundSettings();
   void SetVerticesSettings();
   void SetEdgesSettings();
+  void SetModelSettings();
   void SetResetButton();
   void SetAnimationSettings();
 
@@ -187,7 +188,7 @@ class SettingsWindow : public QWidget {
     if (it != kComboBoxes.end()) {
       it->second->SetOptionByName(new_name);
       settings_->UpdateStrategy();
-      main_viewer_->update();
+      main_viewer_->RequestRedraw();
     }
   }
 
@@ -195,7 +196,7 @@ class SettingsWindow : public QWidget {
     auto it = kSliders.find(slider);
     if (it != kSliders.end()) {
       it->second->SetSize(new_size);
-      main_viewer_->update();
+      main_viewer_->RequestRedraw();
     }
   }
 
@@ -203,13 +204,13 @@ class SettingsWindow : public QWidget {
     auto it = kSpinBoxes.find(spin_box);
     if (it != kSpinBoxes.end()) {
       it->second->SetSize(new_size);
-      main_viewer_->update();
+      main_viewer_->RequestRedraw();
     }
   }
 
   Q_SLOT void OnReset() {
     settings_->ResetSettings();
-    main_viewer_->update();
+    main_viewer_->RequestRedraw();
     AlignWithSettings();
   }
 
@@ -222,6 +223,7 @@ class SettingsWindow : public QWidget {
 
   QComboBox *bg_color_combo_{nullptr};
   QComboBox *projection_combo_{nullptr};
+  QComboBox *renderer_combo_{nullptr};
 
   QComboBox *vertex_color_combo_{nullptr};
   QSlider *vertex_size_slider_{nullptr};
@@ -231,6 +233,8 @@ class SettingsWindow : public QWidget {
   QSlider *edge_thickness_slider_{nullptr};
   QComboBox *edge_type_combo_{nullptr};
 
+  QComboBox *weld_combo_{nullptr};
+
   QSpinBox *duration_spin_{nullptr};
   QSpinBox *fps_spin_{nullptr};
   QSpinBox *width_spin_{nullptr};
@@ -0,0 +1,56 @@
+#ifndef VIEW_SHADERS_H_
+#define VIEW_SHADERS_H_
+
+namespace s21 {
+
+// Vertex attribute and uniform names shared by Scene and OpenGLStrategy
+const int kPositionAttribute = 0;
+const char kPositionName[] = "position";
+const char kMvpUniform[] = "mvp";
+const char kViewportUniform[] = "viewport";
+const char kColorUniform[] = "color";
+const char kStippleUniform[] = "stipple_pattern";
+const char kIsPointUniform[] = "is_point";
+const char kRoundPointsUniform[] = "round_points";
+
+// Window position of the line's provoking vertex next to the interpolated
+// one: their distance in pixels picks the stipple bit, like glLineStipple
+// with a factor of 1 does
+const char kWireframeVertexShader[] = R"(#version 330 core
+layout(location = 0) in vec3 position;
+uniform mat4 mvp;
+uniform vec2 viewport;
+flat out vec2 line_start;
+noperspective out vec2 line_position;
+
+void main() {
+  gl_Position = mvp * vec4(position, 1.0);
+  vec2 window = (gl_Position.xy / gl_Position.w * 0.5 + 0.5) * viewport;
+  line_start = window;
+  line_position = window;
+}
+)";
+
+// Points are squares unless round_points cuts the corners off
+const char kWireframeFragmentShader[] = R"(#version 330 core
+uniform vec3 color;
+uniform int stipple_pattern;
+uniform bool is_point;
+uniform bool round_points;
+flat in vec2 line_start;
+noperspective in vec2 line_position;
+out vec4 frag_color;
+
+void main() {
+  if (is_point) {
+    if (round_points && length(gl_PointCoord - vec2(0.5)) > 0.5) discard;
+  } else {
+    int bit = int(length(line_position - line_start)) & 15;
+    if (((stipple_pattern >> bit) & 1) == 0) discard;
+  }
+  frag_color = vec4(color, 1.0);
+}
+)";
+}  // namespace s21
+
+#endif  // VIEW_SHADERS_H_
@@ -23,7 +23,21 @@ void ViewerWidget::InitializeWidgets() {
   SetButtonIcon(":files/gif_lib/gif_image/icon_record.png",
                 record_animation_button_, kIconWidth, kIconHeight);
 
+  cancel_load_button_ = new QPushButton(tr("Cancel loading"));
+  SetupRoundButton(cancel_load_button_, kIconWidth, kIconHeight);
+  load_progress_bar_ = new QProgressBar(this);
+  load_progress_bar_->setRange(0, kLoadProgressSteps);
+  load_progress_bar_->setStyleSheet(commonStyle);
+  model_loader_ = new ModelLoader(this);
+  lod_builder_ = new LodBuilder(this);
+  SetLoadingState(false);
+
   object_info_label_ = new QLabel(tr("No object loaded"), this);
+  frame_stats_label_ = new QLabel(tr("No frames drawn yet"), this);
+  // Polled rather than signalled per frame, so the label never drives
+  // repaints of its own
+  frame_stats_timer_ = new QTimer(this);
+  frame_stats_timer_->start(kFrameStatsIntervalMs);
 
   // Initialize panels
   left_panel_ = new QScrollArea(this);
@@ -41,6 +55,21 @@ void ViewerWidget::InitializeWidgets() {
           &ViewerWidget::SaveImage);
   connect(record_animation_button_, &QPushButton::clicked, this,
           &ViewerWidget::StartRecordingAnimation);
+  connect(cancel_load_button_, &QPushButton::clicked, this,
+          &ViewerWidget::CancelLoading);
+  connect(model_loader_, &ModelLoader::ProgressChanged, this,
+          &ViewerWidget::OnLoadProgress);
+  connect(model_loader_, &ModelLoader::BatchesReady, this,
+          &ViewerWidget::OnBatchesReady);
+  connect(model_loader_, &ModelLoader::Loaded, this,
+          &ViewerWidget::OnModelLoaded);
+  connect(model_loader_, &ModelLoader::Failed, this,
+          &ViewerWidget::OnLoadFailed);
+  connect(model_loader_, &ModelLoader::Cancelled, this,
+          &ViewerWidget::OnLoadCancelled);
+  connect(frame_stats_timer_, &QTimer::timeout, this,
+          &ViewerWidget::UpdateFrameStats);
+  connect(lod_builder_, &LodBuilder::Built, this, &ViewerWidget::OnLodBuilt);
 }
 
 void ViewerWidget::SetupRoundButton(QPushButton* button, int width,
@@ -65,6 +94,8 @@ void ViewerWidget::SetLeftPanel() {
   button_layout->addWidget(open_file_button_);
   button_layout->addWidget(record_animation_button_);
   button_layout->addWidget(save_image_button_);
+  button_layout->addWidget(load_progress_bar_);
+  button_layout->addWidget(cancel_load_button_);
 
   auto* temp_widget = new QWidget;
   auto* temp_layout = new QVBoxLayout(temp_widget);
@@ -72,6 +103,7 @@ void ViewerWidget::SetLeftPanel() {
   temp_layout->addWidget(settings_window_);
   temp_layout->addStretch();
   temp_layout->addWidget(object_info_label_);
+  temp_layout->addWidget(frame_stats_label_);
 
   left_panel_->setWidget(temp_widget);
   left_panel_->setWidgetResizable(true);
@@ -113,22 +145,71 @@ void ViewerWidget::ShowError() {
   }
 }
 
-void ViewerWidget::UpdateObjectInfo() {
+void ViewerWidget::UpdateObjectInfo(bool continues_stream) {
   if (!current_object_ || current_object_->GetId() < 0) {
     ShowError();
     return;
   }
 
+  lod_chain_.reset();
+  object_info_label_->setText(QString::fromStdString(FormatObjectInfo()));
+  main_viewer_->SetModel(current_object_, continues_stream);
+  // Coarser levels follow once they are built
+  lod_builder_->Start(current_object_);
+}
+
+std::string ViewerWidget::FormatObjectInfo() const {
   std::ostringstream info;
   info << "Object Name: " << current_object_->GetName() << "\n"
        << "Object ID: " << current_object_->GetId() << "\n"
-       << "Number of vertices: " << current_object_->GetVertices().size()
-       << "\n"
-       << "Number of faces: " << current_object_->GetFaces().size();
+       << "Number of vertices: " << current_object_->GetVertexCount() << "\n"
+       << "Number of faces: " << current_object_->GetFaceCount();
+  if (current_object_->IsPointCloud()) info << " (point cloud)";
+  info << "\nNumber of edges: " << current_object_->GetEdges().size();
+  if (const auto &weld = current_object_->GetWeldStats()) {
+    info << "\nWelded vertices: " << weld->vertices_before << " -> "
+         << weld->vertices_after << " in " << std::fixed
+         << std::setprecision(1) << weld->milliseconds << " ms";
+  }
+  if (lod_chain_) {
+    for (std::size_t i = 0; i < lod_chain_->size(); ++i) {
+      const MeshLod &lod = (*lod_chain_)[i];
+      info << "\nLOD " << i + 1 << ": " << lod.faces.size()
+           << " triangles in " << std::fixed << std::setprecision(1)
+           << lod.milliseconds << " ms";
+    }
+  }
+  return info.str();
+}
+
+void ViewerWidget::OnLodBuilt(std::shared_ptr<const WireframeObject> model,
+                              std::shared_ptr<const LodChain> chain) {
+  if (model != current_object_) return;
+  lod_chain_ = chain;
+  object_info_label_->setText(QString::fromStdString(FormatObjectInfo()));
+  main_viewer_->SetLods(std::move(model), std::move(chain));
+}
 
-  object_info_label_->setText(QString::fromStdString(info.str()));
-  main_viewer_->SetModel(current_object_);
-  main_viewer_->update();
+void ViewerWidget::UpdateFrameStats() {
+  const FrameStats &stats = main_viewer_->GetFrameStats();
+  double average_ms =
+      stats.repaints == 0 ? 0.0 : stats.total_frame_ms / stats.repaints;
+  std::ostringstream text;
+  text << std::fixed << std::setprecision(2)
+       << "Frame time: " << stats.last_frame_ms << " ms (average "
+       << average_ms << " ms)\n"
+       << "Repaints: " << stats.repaints << ", skipped: " << stats.skipped;
+  frame_stats_label_->setText(QString::fromStdString(text.str()));
+}
+
+void ViewerWidget::SetLoadingState(bool is_loading) {
+  open_file_button_->setEnabled(!is_loading);
+  load_progress_bar_->setVisible(is_loading);
+  cancel_load_button_->setVisible(is_loading);
+  if (is_loading) {
+    load_progress_bar_->setValue(0);
+    load_progress_bar_->setFormat("%p%");
+  }
 }
 
 void ViewerWidget::GetLastLine(std::ifstream& input_fstream,
@@ -14,6 +14,7 @@ extern "C" {
 #include <QImage>
 #include <QLabel>
 #include <QMessageBox>
+#include <QProgressBar>
 #include <QPushButton>
 #include <QScrollArea>
 #include <QTextEdit>
@@ -21,12 +22,15 @@ extern "C" {
 #include <QVBoxLayout>
 #include <QWidget>
 #include <fstream>
+#include <iomanip>
 #include <memory>
 #include <sstream>
 #include <string>
 
 #include "model/errors.h"
 #include "model/parser.h"
+#include "view/lod_builder.h"
+#include "view/model_loader.h"
 #include "view/scene.h"
 #include "view/settings_facade.h"
 #include "view/settings_gui.h"
@@ -46,6 +50,12 @@ const int kIconHeight = 35;
 const int kStdMarginLeft = 40;
 const int kStdMarginUp = 20;
 
+// Load progress bar steps, bytes are scaled down to this range
+const int kLoadProgressSteps = 1000;
+
+// Refresh period of the frame statistics label
+const int kFrameStatsIntervalMs = 1000;
+
 /**
  * @class ViewerWidget
  * @brief Main widget for the 3D model viewer application
@@ -69,6 +79,16 @@ class ViewerWidget : public QWidget {
  private:
   Q_SLOT void OpenFile();
   Q_SLOT void SaveImage();
+  Q_SLOT void CancelLoading();
+  Q_SLOT void OnLoadProgress(quint64 bytes_processed, quint64 total_bytes,
+                             quint64 records_parsed);
+  Q_SLOT void OnBatchesReady();
+  Q_SLOT void OnModelLoaded(std::shared_ptr<WireframeObject> model);
+  Q_SLOT void OnLoadFailed();
+  Q_SLOT void OnLoadCancelled();
+  Q_SLOT void UpdateFrameStats();
+  Q_SLOT void OnLodBuilt(std::shared_ptr<const WireframeObject> model,
+                         std::shared_ptr<const LodChain> chain);
 
  private:
   // UI initialization methods
@@ -79,7 +99,10 @@ class ViewerWidget : public QWidget {
 
   // Logic methods
   void ShowError();
-  void UpdateObjectInfo();
+  // continues_stream: current_object_ was streamed into the scene
+  void UpdateObjectInfo(bool continues_stream = false);
+  std::string FormatObjectInfo() const;
+  void SetLoadingState(bool is_loading);
   void SetButtonIcon(const QString& imagePath, QPushButton* button, int width,
                      int height);
 
@@ -97,8 +120,12 @@ class ViewerWidget : public QWidget {
   QPushButton* open_file_button_{nullptr};
   QPushButton* save_image_button_{nullptr};
   QPushButton* record_animation_button_{nullptr};
+  QPushButton* cancel_load_button_{nullptr};
+  QProgressBar* load_progress_bar_{nullptr};
 
   QLabel* object_info_label_{nullptr};
+  QLabel* frame_stats_label_{nullptr};
+  QTimer* frame_stats_timer_{nullptr};
   Scene* main_viewer_{nullptr};
   QTextEdit* log_viewer_{nullptr};
 
@@ -108,6 +135,10 @@ class ViewerWidget : public QWidget {
 
   // Model data
   std::shared_ptr<WireframeObject> current_object_{nullptr};
+  ModelLoader* model_loader_{nullptr};
+  // Coarser levels of current_object_, built after it loads
+  LodBuilder* lod_builder_{nullptr};
+  std::shared_ptr<const LodChain> lod_chain_;
 };
 
 }  // namespace s21